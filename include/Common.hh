@@ -9,6 +9,7 @@
 
 #include <array>
 #include <cassert>
+#include <cstring>
 #include <limits>
 
 typedef int8_t s8;
@@ -393,3 +394,59 @@ static inline constexpr T parse(T val, std::endian endian = std::endian::big) {
 static inline constexpr u32 f2u(f32 val) {
     return std::bit_cast<u32>(val);
 }
+
+// 64-bit FNV-1a hash, used to key on-disk caches by the contents of their source file
+static inline constexpr u64 HashFnv1a64(const u8 *data, size_t size) {
+    u64 hash = 0xCBF29CE484222325;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3;
+    }
+    return hash;
+}
+
+// 64-bit FNV-1a hash of a null-terminated string, which can be computed at compile time
+static inline constexpr u64 HashFnv1a64(const char *str) {
+    u64 hash = 0xCBF29CE484222325;
+    for (; *str != '\0'; ++str) {
+        hash = (hash ^ static_cast<u8>(*str)) * 0x100000001B3;
+    }
+    return hash;
+}
+
+// 64-bit hash of a large buffer, for caches which must be keyed faster than the data is processed.
+// Four independent lanes consume 32 bytes per step, which makes it an order of magnitude faster
+// than HashFnv1a64. Words are read in native byte order, so the hash depends on the platform.
+static inline u64 HashLanes64(const u8 *data, size_t size) {
+    constexpr u64 PRIME1 = 0x9E3779B185EBCA87;
+    constexpr u64 PRIME2 = 0xC2B2AE3D27D4EB4F;
+
+    auto round = [](u64 acc, u64 word) { return std::rotl(acc + word * PRIME2, 31) * PRIME1; };
+
+    u64 lanes[4] = {PRIME1 + PRIME2, PRIME2, 0, 0 - PRIME1};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            u64 word;
+            memcpy(&word, data + i + lane * 8, sizeof(word));
+            lanes[lane] = round(lanes[lane], word);
+        }
+    }
+
+    u64 hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) +
+            std::rotl(lanes[3], 18);
+    for (u64 lane : lanes) {
+        hash = (hash ^ round(0, lane)) * PRIME1;
+    }
+
+    // The remaining bytes and the size are mixed in like FNV-1a
+    for (; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3;
+    }
+    hash = (hash ^ size) * PRIME1;
+
+    // Avalanche, so that every input bit affects every output bit
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    return hash;
+}
@@ -125,6 +125,10 @@ ArchiveHandle::Node *ArchiveHandle::node(s32 entryId) const {
     return reinterpret_cast<Node *>(nodeAddress);
 }
 
+const char *ArchiveHandle::name(s32 entryId) const {
+    return m_strings + node(entryId)->stringOffset();
+}
+
 void *ArchiveHandle::startAddress() const {
     return m_startAddress;
 }
@@ -62,6 +62,7 @@ public:
 
     [[nodiscard]] void *getFileAddress(const FileInfo &info) const;
     [[nodiscard]] Node *node(s32 entryId) const;
+    [[nodiscard]] const char *name(s32 entryId) const;
     [[nodiscard]] void *startAddress() const;
 
 private:
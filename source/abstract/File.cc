@@ -1,17 +1,33 @@
 #include "File.hh"
 
+#include <filesystem>
 #include <fstream>
 
-namespace Abstract::File {
+#if defined(__unix__) || defined(__APPLE__)
+#define FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-u8 *Load(const char *path, size_t &size) {
-    char filepath[256];
+namespace Abstract::File {
 
+/// @brief Resolves a path relative to the working directory, with or without a leading slash.
+/// @details This is how Load and MappedFile resolve their paths, so callers checking for a file
+/// before loading it should check the resolved path.
+void ResolvePath(const char *path, char *buffer, size_t size) {
     if (path[0] == '/') {
         path++;
     }
 
-    snprintf(filepath, sizeof(filepath), "./%s", path);
+    snprintf(buffer, size, "./%s", path);
+}
+
+u8 *Load(const char *path, size_t &size) {
+    char filepath[256];
+    ResolvePath(path, filepath, sizeof(filepath));
+
     std::ifstream file(filepath, std::ios::binary);
     if (!file) {
         PANIC("File with provided path %s was not loaded correctly!", path);
@@ -37,4 +53,142 @@ int Remove(const char *path) {
     return std::remove(path);
 }
 
+/// @brief Maps a file into memory read-only.
+/// @details Unlike Load, the path is used as is, rather than relative to the working directory.
+/// Pages are only read from disk once accessed, and are shared with every other process which
+/// maps the same file. Where mapping is not supported, the file is loaded instead.
+/// @param path The path to the file.
+/// @param size Receives the size of the file.
+/// @return The contents of the file, or nullptr if it cannot be opened or is empty. Must be
+/// released with Unmap.
+const u8 *Map(const char *path, size_t &size) {
+    size = 0;
+
+#ifdef FILE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping holds its own reference to the file
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    size = st.st_size;
+    return reinterpret_cast<const u8 *>(data);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file || file.tellg() <= 0) {
+        return nullptr;
+    }
+
+    size = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    u8 *buffer = new u8[size];
+    file.read(reinterpret_cast<char *>(buffer), size);
+    return buffer;
+#endif
+}
+
+/// @brief Releases a file mapped with Map.
+void Unmap(const u8 *data, size_t size) {
+#ifdef FILE_MMAP
+    munmap(const_cast<u8 *>(data), size);
+#else
+    (void)size;
+    delete[] data;
+#endif
+}
+
+/// @brief Writes a file such that other processes never observe it partially written.
+/// @details The data is written to a temporary file next to the destination, which then replaces
+/// the destination. If several processes write the same file at once, one of them wins.
+/// @return Whether the file was written.
+bool WriteAtomic(const char *path, const void *data, size_t size) {
+    char tmpPath[512];
+#ifdef FILE_MMAP
+    snprintf(tmpPath, sizeof(tmpPath), "%s.%d.tmp", path, static_cast<int>(getpid()));
+#else
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+#endif
+
+    {
+        std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!stream.write(reinterpret_cast<const char *>(data), size)) {
+            stream.close();
+            std::remove(tmpPath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::remove(tmpPath);
+        return false;
+    }
+
+    return true;
+}
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0) {}
+
+/// @brief Maps a file, which must exist.
+/// @param path The path to the file, resolved the same way as with Load.
+MappedFile::MappedFile(const char *path) : MappedFile() {
+    char filepath[256];
+    ResolvePath(path, filepath, sizeof(filepath));
+
+    m_data = Map(filepath, m_size);
+
+    // Empty files cannot be mapped, but are still valid files
+    std::error_code ec;
+    if (!m_data && !std::filesystem::is_regular_file(filepath, ec)) {
+        PANIC("File with provided path %s was not loaded correctly!", path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    reset();
+}
+
+MappedFile::MappedFile(MappedFile &&other) : m_data(other.m_data), m_size(other.m_size) {
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) {
+    if (this != &other) {
+        reset();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+
+    return *this;
+}
+
+/// @brief Unmaps the file, leaving the view empty.
+void MappedFile::reset() {
+    if (m_data) {
+        Unmap(m_data, m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
 } // namespace Abstract::File
@@ -4,8 +4,45 @@
 
 namespace Abstract::File {
 
+void ResolvePath(const char *path, char *buffer, size_t size);
+
 [[nodiscard]] u8 *Load(const char *path, size_t &size);
 void Append(const char *path, const char *data, size_t size);
 int Remove(const char *path);
 
+[[nodiscard]] const u8 *Map(const char *path, size_t &size);
+void Unmap(const u8 *data, size_t size);
+bool WriteAtomic(const char *path, const void *data, size_t size);
+
+/// @brief A read-only view of a file, which is unmapped once the view is destroyed.
+/// @details Unlike Load, no buffer is allocated and nothing is copied, as the file is mapped into
+/// memory with Map. Paths are resolved the same way as with Load.
+class MappedFile {
+public:
+    MappedFile();
+    explicit MappedFile(const char *path);
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other);
+    MappedFile &operator=(MappedFile &&other);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    void reset();
+
+    /// @brief The contents of the file, or nullptr if the view is empty.
+    [[nodiscard]] const u8 *data() const {
+        return m_data;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return m_size;
+    }
+
+private:
+    const u8 *m_data;
+    size_t m_size;
+};
+
 } // namespace Abstract::File
@@ -0,0 +1,146 @@
+#include "SharedMemory.hh"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SHARED_MEMORY_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <cstring>
+#include <filesystem>
+#include <string>
+#endif
+
+namespace Abstract::SharedMemory {
+
+/// @brief Maps an existing segment read-only.
+/// @param name The name of the segment, starting with a slash.
+/// @param size Receives the size of the segment.
+/// @return The segment, or nullptr if it does not exist or segments are unsupported. Must be
+/// released with Unmap.
+const u8 *Open(const char *name, size_t &size) {
+    size = 0;
+
+#ifdef SHARED_MEMORY_POSIX
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+
+    void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    // The mapping holds its own reference to the segment
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    size = st.st_size;
+    return reinterpret_cast<const u8 *>(data);
+#else
+    (void)name;
+    return nullptr;
+#endif
+}
+
+/// @brief Creates a zero-initialized segment and maps it writable, unless it already exists.
+/// @details Only one process can create a given segment, so the creator is the only writer. Other
+/// processes may open the segment before it is written, so its contents must signal once they are
+/// complete.
+/// @param name The name of the segment, starting with a slash.
+/// @param size The size of the segment.
+/// @return The segment, or nullptr if it already exists or cannot be created. Must be sealed with
+/// Seal once written.
+u8 *Create(const char *name, size_t size) {
+#ifdef SHARED_MEMORY_POSIX
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return nullptr;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        shm_unlink(name);
+        return nullptr;
+    }
+
+    return reinterpret_cast<u8 *>(data);
+#else
+    (void)name;
+    (void)size;
+    return nullptr;
+#endif
+}
+
+/// @brief Makes a segment returned by Create read-only, once it is written.
+/// @return The same segment. Must be released with Unmap.
+const u8 *Seal(u8 *data, size_t size) {
+#ifdef SHARED_MEMORY_POSIX
+    mprotect(data, size, PROT_READ);
+#else
+    (void)size;
+#endif
+
+    return data;
+}
+
+/// @brief Removes a segment by name. Processes which mapped the segment keep their mapping.
+void Remove(const char *name) {
+#ifdef SHARED_MEMORY_POSIX
+    shm_unlink(name);
+#else
+    (void)name;
+#endif
+}
+
+/// @brief Removes every segment whose name starts with the given prefix.
+/// @details Segments can only be listed on Linux, where they live in /dev/shm. Elsewhere, nothing
+/// is removed.
+/// @param prefix The prefix of the names, starting with a slash.
+void RemoveAll(const char *prefix) {
+#ifdef __linux__
+    ASSERT(prefix[0] == '/');
+    size_t length = strlen(prefix + 1);
+
+    std::error_code ec;
+    std::filesystem::directory_iterator it("/dev/shm", ec);
+    for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.compare(0, length, prefix + 1) == 0) {
+            Remove(("/" + name).c_str());
+        }
+    }
+#else
+    (void)prefix;
+#endif
+}
+
+/// @brief Releases a segment mapped with Open or Create.
+void Unmap(const void *data, size_t size) {
+#ifdef SHARED_MEMORY_POSIX
+    munmap(const_cast<void *>(data), size);
+#else
+    (void)data;
+    (void)size;
+#endif
+}
+
+} // namespace Abstract::SharedMemory
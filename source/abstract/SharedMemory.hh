@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Common.hh>
+
+/// @brief Named memory segments, which any process can map by name until the system restarts.
+namespace Abstract::SharedMemory {
+
+[[nodiscard]] const u8 *Open(const char *name, size_t &size);
+[[nodiscard]] u8 *Create(const char *name, size_t size);
+[[nodiscard]] const u8 *Seal(u8 *data, size_t size);
+void Remove(const char *name);
+void RemoveAll(const char *prefix);
+void Unmap(const void *data, size_t size);
+
+} // namespace Abstract::SharedMemory
@@ -0,0 +1,53 @@
+#include "Thread.hh"
+
+namespace Abstract {
+
+Thread::Thread() : m_func(nullptr), m_arg(nullptr), m_running(false) {}
+
+/// @brief Joins the thread, if it is still running.
+Thread::~Thread() {
+    join();
+}
+
+/// @brief Runs a function on a new thread.
+/// @details If the thread cannot be created, the function runs on the calling thread instead.
+/// @param func The function to run.
+/// @param arg The argument passed into the function.
+void Thread::start(Func func, void *arg) {
+    ASSERT(!m_running);
+
+    m_func = func;
+    m_arg = arg;
+
+#ifdef THREAD_PTHREAD
+    if (pthread_create(&m_handle, nullptr, Run, this) == 0) {
+        m_running = true;
+        return;
+    }
+
+    WARN("Failed to create a thread! Running its function synchronously");
+#endif
+
+    m_func(m_arg);
+}
+
+/// @brief Waits for the function to return.
+void Thread::join() {
+    if (!m_running) {
+        return;
+    }
+
+#ifdef THREAD_PTHREAD
+    pthread_join(m_handle, nullptr);
+#endif
+
+    m_running = false;
+}
+
+void *Thread::Run(void *thread) {
+    auto *self = reinterpret_cast<Thread *>(thread);
+    self->m_func(self->m_arg);
+    return nullptr;
+}
+
+} // namespace Abstract
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Common.hh>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define THREAD_PTHREAD
+#include <pthread.h>
+#endif
+
+namespace Abstract {
+
+/// @brief A thread which runs a single function, without allocating from the engine heaps.
+/// @details std::thread allocates its state with the global operator new, which Kinoko routes to
+/// the heaps of the calling thread's engine context, and then frees it on the new thread. This
+/// uses the platform's threads directly instead. The function must not allocate from the heaps
+/// either, as they are not thread-safe. If threads are unavailable, the function runs on the
+/// calling thread when the thread is started.
+class Thread {
+public:
+    typedef void (*Func)(void *arg);
+
+    Thread();
+    ~Thread();
+
+    Thread(const Thread &) = delete;
+    Thread &operator=(const Thread &) = delete;
+
+    void start(Func func, void *arg);
+    void join();
+
+private:
+    static void *Run(void *thread);
+
+    Func m_func;
+    void *m_arg;
+    bool m_running;
+#ifdef THREAD_PTHREAD
+    pthread_t m_handle;
+#endif
+};
+
+} // namespace Abstract
@@ -197,6 +197,26 @@ void MEMiExpHeapHead::visitAllocated(Visitor visitor, uintptr_t param) {
     }
 }
 
+/// @brief Calls the visitor with the memory region of every free block, excluding its header.
+void MEMiExpHeapHead::visitFree(const RegionVisitor &visitor) const {
+    for (MEMiExpBlockHead *block = m_freeBlocks.m_head; block; block = block->m_link.m_next) {
+        visitor(Region(block->getMemoryStart(), block->getMemoryEnd()));
+    }
+}
+
+/// @brief Returns the size of an allocated block, excluding its header.
+/// @details This is at least the size which was requested, and covers the whole object when the
+/// block holds an instance of a derived class.
+u32 MEMiExpHeapHead::getSizeForMBlock(const void *block) {
+    constexpr u16 USED_BLOCK_SIGNATURE = 0x5544; // UD
+
+    const MEMiExpBlockHead *head =
+            reinterpret_cast<MEMiExpBlockHead *>(SubOffset(block, sizeof(MEMiExpBlockHead)));
+    ASSERT(head->m_signature == USED_BLOCK_SIGNATURE);
+
+    return head->m_size;
+}
+
 /// @addr{0x8019934C}
 u16 MEMiExpHeapHead::getGroupID() const {
     return m_groupId;
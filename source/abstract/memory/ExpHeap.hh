@@ -73,6 +73,7 @@ private:
 
 public:
     typedef std::function<void(void *, MEMiHeapHead *, uintptr_t)> Visitor;
+    typedef std::function<void(const Region &)> RegionVisitor;
 
     static MEMiExpHeapHead *create(void *startAddress, size_t size, u16 flag);
     void destroy();
@@ -81,6 +82,9 @@ public:
     void free(void *block);
     [[nodiscard]] u32 getAllocatableSize(s32 align) const;
     void visitAllocated(Visitor visitor, uintptr_t param);
+    void visitFree(const RegionVisitor &visitor) const;
+
+    [[nodiscard]] static u32 getSizeForMBlock(const void *block);
 
     [[nodiscard]] u16 getGroupID() const;
     void setGroupID(u16 groupID);
@@ -1,5 +1,7 @@
 #include "HeapCommon.hh"
 
+#include <egg/core/EngineContext.hh>
+
 #include <cstring>
 
 namespace Abstract::Memory {
@@ -16,8 +18,14 @@ void *MEMiHeapHead::getHeapEnd() {
     return m_heapEnd;
 }
 
+/// @brief Whether memory is overwritten when it is allocated, such that the contents of free memory
+/// can never be observed.
+bool MEMiHeapHead::isAllocFilled() const {
+    return m_optFlag.onBit(eOptFlag::ZeroFillAlloc, eOptFlag::DebugFillAlloc);
+}
+
 MEMList &MEMiHeapHead::getRootList() {
-    return s_rootList;
+    return Kinoko::EngineContext::Current()->rootList;
 }
 
 u32 MEMiHeapHead::getFillVal(FillType type) {
@@ -28,7 +36,7 @@ u32 MEMiHeapHead::getFillVal(FillType type) {
 
 /// @addr{0x80198658}
 MEMiHeapHead *MEMiHeapHead::findContainHeap(const void *block) {
-    return findContainHeap(&s_rootList, block);
+    return findContainHeap(&getRootList(), block);
 }
 
 /// @addr{0x8019832C}
@@ -96,6 +104,4 @@ MEMList &MEMiHeapHead::findListContainHeap() const {
     return containHeap ? containHeap->getChildList() : getRootList();
 }
 
-MEMList MEMiHeapHead::s_rootList = MEMList(MEMiHeapHead::getLinkOffset());
-
 } // namespace Abstract::Memory
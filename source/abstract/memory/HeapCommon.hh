@@ -27,6 +27,7 @@ public:
     [[nodiscard]] MEMList &getChildList();
     [[nodiscard]] void *getHeapStart();
     [[nodiscard]] void *getHeapEnd();
+    [[nodiscard]] bool isAllocFilled() const;
 
     [[nodiscard]] static MEMList &getRootList();
     [[nodiscard]] static u32 getFillVal(FillType type);
@@ -55,7 +56,6 @@ private:
     void *m_heapStart;
     void *m_heapEnd;
 
-    static MEMList s_rootList;
     static constexpr std::array<u32, 3> s_fillVals = {{
             0xC3C3C3C3,
             0xF3F3F3F3,
@@ -1,17 +1,27 @@
 #include "Archive.hh"
 
+#include "egg/core/EngineContext.hh"
+
 #include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstring>
+#include <string>
+#include <unordered_map>
 
 namespace EGG {
 
+/// @brief Marks an index slot whose hash is shared by several paths, which are left unindexed.
+static constexpr s32 COLLIDING_ENTRY_ID = -2;
+
 /// @brief Removes the archive from the static list.
 /// @addr{0x8020f6ec}
 /// @details Called when the archive's reference count becomes 0.
 Archive::~Archive() {
-    auto iter = std::find(s_archiveList.begin(), s_archiveList.end(), this);
-    if (iter != s_archiveList.end()) {
-        s_archiveList.erase(iter);
+    auto &archiveList = Kinoko::EngineContext::Current()->archiveList;
+    auto iter = std::find(archiveList.begin(), archiveList.end(), this);
+    if (iter != archiveList.end()) {
+        archiveList.erase(iter);
     }
 }
 
@@ -27,6 +37,20 @@ s32 Archive::convertPathToEntryId(const char *path) const {
     return m_handle.convertPathToEntryId(path);
 }
 
+/// @brief Looks up a path in the index, falling back to searching the node table if it is missing.
+/// @details Only paths which resolve to the same entry either way are indexed, so this always
+/// returns the same entry as the node table search.
+s32 Archive::convertPathToEntryId(const Path &path) const {
+    if (!m_index.empty()) {
+        const IndexSlot &slot = m_index[findSlot(path.hash)];
+        if (slot.entryId >= 0) {
+            return slot.entryId;
+        }
+    }
+
+    return m_handle.convertPathToEntryId(path.path);
+}
+
 /// @addr{0x8020fa80}
 void *Archive::getFileFast(s32 entryId, Abstract::ArchiveHandle::FileInfo &info) const {
     m_handle.open(entryId, info);
@@ -40,7 +64,8 @@ void *Archive::getFileFast(s32 entryId, Abstract::ArchiveHandle::FileInfo &info)
 Archive *Archive::FindArchive(void *archiveStart) {
     ASSERT(archiveStart);
 
-    for (auto iter = s_archiveList.begin(); iter != s_archiveList.end(); ++iter) {
+    auto &archiveList = Kinoko::EngineContext::Current()->archiveList;
+    for (auto iter = archiveList.begin(); iter != archiveList.end(); ++iter) {
         if ((*iter)->m_handle.startAddress() == archiveStart) {
             return *iter;
         }
@@ -59,7 +84,7 @@ Archive *Archive::Mount(void *archiveStart) {
     if (!archive) {
         // Create a new archive and add it to the list
         archive = new Archive(archiveStart);
-        s_archiveList.push_back(archive);
+        Kinoko::EngineContext::Current()->archiveList.push_back(archive);
     } else {
         // It already exists, increase the reference count
         archive->m_refCount++;
@@ -69,8 +94,118 @@ Archive *Archive::Mount(void *archiveStart) {
 }
 
 /// @addr{Inlined in 0x8020F768}
-Archive::Archive(void *archiveStart) : m_handle(archiveStart) {}
+/// @details Kinoko also builds the path index here, once per mount.
+Archive::Archive(void *archiveStart) : m_handle(archiveStart) {
+    buildIndex();
+}
+
+/// @brief Indexes the full path of every file in the archive by its hash.
+/// @details The node table is walked in order, tracking the path of each enclosing directory. "."
+/// directories are skipped over, as the node table search looks through them.
+///
+/// The node table search matches each component of a path against the first entry in the current
+/// directory, or any of its subdirectories, whose name starts with the component. A file is only
+/// indexed if every component of its path resolves to the file or to its enclosing directory, so
+/// that an index hit always returns the same entry as the search. To check this without searching,
+/// the walk keeps track of the last entry so far whose name starts with each prefix. If that entry
+/// is within the enclosing directory, it shadows the current entry. Paths whose hashes collide are
+/// left out too, and lookups of unindexed paths fall back to the node table search.
+void Archive::buildIndex() {
+    // A directory enclosing the current node
+    struct Directory {
+        u32 entryId;
+        u32 end;         ///< The node after the directory's last descendant.
+        size_t pathSize; ///< The size of the path before the directory's name was appended.
+        bool reachable;  ///< Whether the node table search resolves the directory's path to it.
+    };
+
+    u32 count = parse<u32>(m_handle.node(0)->m_directory.next);
+    u32 fileCount = 0;
+    for (u32 i = 1; i < count; ++i) {
+        if (!m_handle.node(i)->isDirectory()) {
+            ++fileCount;
+        }
+    }
+
+    if (fileCount == 0) {
+        return;
+    }
+
+    // Keep the load factor at or below one half, so that probe sequences stay short
+    m_index.assign(std::bit_ceil(fileCount * 2), IndexSlot{0, -1});
+
+    // Keyed by the hash of each prefix. A hash collision can only leave a file unindexed.
+    std::unordered_map<u64, u32> lastWithPrefix;
+
+    std::vector<Directory> directories;
+    directories.push_back({0, count, 1, true});
+    std::string path = "/";
+
+    for (u32 i = 1; i < count; ++i) {
+        while (i >= directories.back().end) {
+            path.resize(directories.back().pathSize);
+            directories.pop_back();
+        }
+
+        const auto *node = m_handle.node(i);
+        const char *name = m_handle.name(i);
+        const Directory &parent = directories.back();
 
-std::list<Archive *> Archive::s_archiveList;
+        // The search skips "." entries, so they neither shadow nor enclose anything
+        if (strcmp(name, ".") == 0) {
+            u32 end = parse<u32>(node->m_directory.next);
+            directories.push_back({parent.entryId, end, path.size(), parent.reachable});
+            continue;
+        }
+
+        // The search treats path components starting with ".." as references to the parent
+        auto iter = lastWithPrefix.find(HashFnv1a64(name));
+        bool reachable = parent.reachable && strncmp(name, "..", 2) != 0 &&
+                (iter == lastWithPrefix.end() || iter->second <= parent.entryId);
+
+        u64 prefixHash = HashFnv1a64("");
+        for (const char *c = name; *c != '\0'; ++c) {
+            prefixHash = (prefixHash ^ static_cast<u8>(*c)) * 0x100000001B3;
+            lastWithPrefix[prefixHash] = i;
+        }
+
+        if (node->isDirectory()) {
+            u32 end = parse<u32>(node->m_directory.next);
+            directories.push_back({i, end, path.size(), reachable});
+            path.append(name);
+            path.push_back('/');
+            continue;
+        }
+
+        if (!reachable) {
+            continue;
+        }
+
+        size_t pathSize = path.size();
+        path.append(name);
+
+        u64 hash = Path::Hash(path.c_str());
+        IndexSlot &slot = m_index[findSlot(hash)];
+        if (slot.entryId == -1) {
+            slot = {hash, static_cast<s32>(i)};
+        } else {
+            slot.entryId = COLLIDING_ENTRY_ID;
+        }
+
+        path.resize(pathSize);
+    }
+}
+
+/// @brief Finds the slot holding a hash, or the empty slot where it would be inserted.
+size_t Archive::findSlot(u64 hash) const {
+    size_t mask = m_index.size() - 1;
+    size_t idx = hash & mask;
+
+    while (m_index[idx].entryId != -1 && m_index[idx].hash != hash) {
+        idx = (idx + 1) & mask;
+    }
+
+    return idx;
+}
 
 } // namespace EGG
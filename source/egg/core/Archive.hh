@@ -4,27 +4,54 @@
 
 #include <abstract/Archive.hh>
 
+#include <vector>
+
 /// @brief EGG core library
 namespace EGG {
 
 class Archive : Disposer {
 public:
+    /// @brief A path to a file in an archive, along with its key in the archives' path indices.
+    /// @details Constructing a path from a string literal hashes it at compile time, so constant
+    /// names like "kartParam.bin" cost nothing to look up beyond probing the index.
+    struct Path {
+        consteval Path(const char *path_) : Path(path_, Hash(path_)) {}
+        constexpr Path(const char *path_, u64 hash_) : path(path_), hash(hash_) {}
+
+        /// @brief Hashes a path from the root of an archive, with or without a leading slash.
+        [[nodiscard]] static constexpr u64 Hash(const char *path_) {
+            return HashFnv1a64(path_[0] == '/' ? path_ + 1 : path_);
+        }
+
+        const char *path; ///< Used to search the node table if the path is not indexed.
+        u64 hash;
+    };
+
     ~Archive();
 
     void unmount();
     [[nodiscard]] s32 convertPathToEntryId(const char *path) const;
+    [[nodiscard]] s32 convertPathToEntryId(const Path &path) const;
     void *getFileFast(s32 entryId, Abstract::ArchiveHandle::FileInfo &info) const;
 
     [[nodiscard]] static Archive *FindArchive(void *archiveStart);
     [[nodiscard]] static Archive *Mount(void *archiveStart);
 
 private:
+    /// @brief An entry in the path index, keyed by the hash of the entry's path.
+    struct IndexSlot {
+        u64 hash;
+        s32 entryId; ///< -1 if the slot is empty.
+    };
+
     Archive(void *archiveStart);
 
+    void buildIndex();
+    [[nodiscard]] size_t findSlot(u64 hash) const;
+
     Abstract::ArchiveHandle m_handle;
     s32 m_refCount = 1;
-
-    static std::list<Archive *> s_archiveList; ///< The linked list of all mounted archives.
+    std::vector<IndexSlot> m_index; ///< Open-addressing table, sized to a power of two.
 };
 
 } // namespace EGG
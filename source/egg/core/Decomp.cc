@@ -1,7 +1,34 @@
 #include "Decomp.hh"
 
+#include <bit>
+
 namespace EGG::Decomp {
 
+/// @brief The most bytes a group of eight operations can write, if all are maximum-length runs.
+static constexpr s32 MAX_GROUP_EXPAND_SIZE = 8 * (0xff + 0x12);
+
+/// @brief Copies a back-reference which starts dist bytes before the destination.
+/// @details If the source and destination don't overlap, this is a single wide copy. A distance of
+/// one repeats a single byte. Otherwise the run repeats a pattern of dist bytes, and each copy
+/// doubles the length of pattern available to the next one, which keeps every copy free of
+/// overlap. Each copy starts at a multiple of the pattern length, so the output matches copying a
+/// byte at a time.
+static void CopyRun(u8 *dst, s32 dist, s32 len) {
+    const u8 *from = dst - dist;
+
+    if (dist >= len) {
+        memcpy(dst, from, len);
+    } else if (dist == 1) {
+        memset(dst, *from, len);
+    } else {
+        for (s32 copied = 0; copied < len;) {
+            s32 size = std::min(len - copied, dist + copied);
+            memcpy(dst + copied, from, size);
+            copied += size;
+        }
+    }
+}
+
 /// @addr{0x8021997C}
 s32 GetExpandSize(const u8 *src) {
     if (src[0] == 'Y' && src[1] == 'a' && src[2] == 'z') {
@@ -12,9 +39,62 @@ s32 GetExpandSize(const u8 *src) {
 }
 
 /// @brief Performs YAZ0 decompression on a given buffer.
+/// @details Produces the same output as DecodeSZSBytewise, but copies consecutive literals and
+/// back-references in bulk. The output bounds are only checked per operation in the last groups
+/// of the data, where a group of maximum-length runs could overflow the destination.
 /// @return The size of the decompressed data.
-/// @addr{0x80218C2C}
 s32 DecodeSZS(const u8 *src, u8 *dst) {
+    s32 expandSize = GetExpandSize(src);
+    s32 srcIdx = 0x10;
+    s32 destIdx = 0;
+
+    while (destIdx < expandSize) {
+        u8 code = src[srcIdx++];
+        s32 opCount = 8;
+        bool checkBounds = expandSize - destIdx < MAX_GROUP_EXPAND_SIZE;
+
+        while (opCount > 0 && destIdx < expandSize) {
+            // Direct copy (code bit = 1), for each consecutive set bit
+            s32 literalCount = std::countl_one(code);
+            if (literalCount > 0) {
+                literalCount = std::min(literalCount, expandSize - destIdx);
+                memcpy(dst + destIdx, src + srcIdx, literalCount);
+
+                srcIdx += literalCount;
+                destIdx += literalCount;
+                code <<= literalCount;
+                opCount -= literalCount;
+                continue;
+            }
+
+            // RLE compressed data (code bit = 0)
+            s32 distToDest = (src[srcIdx] << 8) | src[srcIdx + 1];
+            srcIdx += sizeof(u8) * 2;
+            s32 dist = (distToDest & 0xfff) + 1;
+
+            // Upper nibble of byte 1
+            s32 runLen = ((distToDest >> 12) == 0) ? src[srcIdx++] + 0x12 : (distToDest >> 12) + 2;
+
+            if ((checkBounds && runLen > expandSize - destIdx) || dist > destIdx) {
+                PANIC("Malformed compressed SZS data.");
+            }
+
+            CopyRun(dst + destIdx, dist, runLen);
+
+            destIdx += runLen;
+            code <<= 1;
+            --opCount;
+        }
+    }
+
+    return expandSize;
+}
+
+/// @brief Performs YAZ0 decompression on a given buffer, one byte at a time.
+/// @details This matches the game's implementation. It is kept as a reference for DecodeSZS.
+/// @return The size of the decompressed data.
+/// @addr{0x80218C2C}
+s32 DecodeSZSBytewise(const u8 *src, u8 *dst) {
     s32 expandSize = GetExpandSize(src);
     s32 srcIdx = 0x10;
     u8 code = 0;
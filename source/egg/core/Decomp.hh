@@ -6,5 +6,6 @@ namespace EGG::Decomp {
 
 [[nodiscard]] s32 GetExpandSize(const u8 *src);
 s32 DecodeSZS(const u8 *src, u8 *dst);
+s32 DecodeSZSBytewise(const u8 *src, u8 *dst);
 
 } // namespace EGG::Decomp
@@ -0,0 +1,200 @@
+#include "EngineContext.hh"
+
+#include "egg/core/ExpHeap.hh"
+#include "egg/core/SceneManager.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__arm64__) || defined(__aarch64__)
+static void FlushDenormalsToZero() {
+    uint64_t fpcr;
+    asm("mrs %0,   fpcr" : "=r"(fpcr));
+    asm("msr fpcr, %0" ::"r"(fpcr | (1 << 24)));
+}
+#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+
+static void FlushDenormalsToZero() {
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+}
+#endif
+
+namespace Kinoko {
+
+EngineState::EngineState()
+    : resourceManager(nullptr), kPadDirector(nullptr), raceConfig(nullptr), raceManager(nullptr),
+      courseMap(nullptr), kartObjectManager(nullptr), collisionDirector(nullptr),
+      courseColMgr(nullptr), boxColManager(nullptr), objectDirector(nullptr),
+      objectDrivableDirector(nullptr), itemDirector(nullptr), kartParamFileManager(nullptr),
+      dotProductCache({}), heapList(EGG::Heap::getOffset()),
+      rootList(Abstract::Memory::MEMiHeapHead::getLinkOffset()), currentHeap(nullptr),
+      allocatableHeap(nullptr), heapForCreateScene(nullptr), sceneRootHeap(nullptr),
+      rootHeap(nullptr) {}
+
+SaveState::SaveState() : m_context(nullptr), m_data(nullptr), m_dataSize(0), m_capacity(0) {}
+
+SaveState::~SaveState() {
+    std::free(m_data);
+}
+
+EngineContext::EngineContext()
+    : raceConfigInitCallback(nullptr), raceConfigInitCallbackArg(nullptr),
+      kartStageCallback(nullptr), kartStageCallbackArg(nullptr), memorySpace(nullptr),
+      memorySize(0) {}
+
+/// @details The heaps and everything allocated from them live inside the arena, so the arena is
+/// released wholesale rather than tearing down each object. The context must not be bound to any
+/// thread at this point.
+EngineContext::~EngineContext() {
+    if (s_current == this) {
+        Default()->bind();
+    }
+
+    std::free(memorySpace);
+}
+
+/// @brief Creates the root heap from a newly allocated arena of the given size.
+/// @details The context must be bound to the calling thread, as heap bookkeeping is resolved
+/// through the current context.
+/// @param size The size of the arena in bytes.
+void EngineContext::initMemory(size_t size) {
+    ASSERT(s_current == this);
+    ASSERT(!memorySpace);
+
+    Abstract::Memory::MEMiHeapHead::OptFlag opt;
+    opt.setBit(Abstract::Memory::MEMiHeapHead::eOptFlag::ZeroFillAlloc);
+
+#ifdef BUILD_DEBUG
+    opt.setBit(Abstract::Memory::MEMiHeapHead::eOptFlag::DebugFillAlloc);
+#endif
+
+    memorySpace = std::malloc(size);
+    memorySize = size;
+    rootHeap = EGG::ExpHeap::create(memorySpace, size, opt);
+    rootHeap->setName("EGGRoot");
+    rootHeap->becomeCurrentHeap();
+
+    EGG::SceneManager::SetRootHeap(rootHeap);
+}
+
+/// @brief Binds the context to the calling thread.
+/// @details Also configures the thread's floating-point environment, as it is per-thread state.
+/// @return The context previously bound to the calling thread.
+EngineContext *EngineContext::bind() {
+    FlushDenormalsToZero();
+
+    EngineContext *prev = s_current;
+    s_current = this;
+    return prev;
+}
+
+/// @brief Captures the arena and the engine state.
+/// @details All race-lifetime state lives in the arena, or is referenced from the engine state, so
+/// this is a complete snapshot of the simulation. Host state, such as the current frame of a test
+/// case, is not captured. The bodies of free heap blocks are skipped, as heaps overwrite memory
+/// when allocating it. Archives in the System::ArchiveCache and KCL arrays in the
+/// Field::KColDataCache are shared rather than copied, so they must not be evicted while a
+/// snapshot referencing them may still be loaded.
+/// @param state The snapshot to overwrite. Its buffers are reused.
+void EngineContext::saveState(SaveState &state) const {
+    // Free blocks this small cost more to track than to copy
+    constexpr size_t MIN_SKIPPED_SIZE = 0x400;
+
+    ASSERT(memorySpace);
+
+    if (state.m_capacity != memorySize) {
+        std::free(state.m_data);
+        state.m_data = reinterpret_cast<u8 *>(std::malloc(memorySize));
+        state.m_capacity = memorySize;
+        ASSERT(state.m_data);
+    }
+
+    auto &skipped = state.m_spans;
+    skipped.clear();
+
+    auto *arena = reinterpret_cast<u8 *>(memorySpace);
+    visitFree([&](const Abstract::Memory::Region &region) {
+        if (region.getRange() >= MIN_SKIPPED_SIZE) {
+            auto *start = reinterpret_cast<u8 *>(region.start);
+            skipped.push_back({static_cast<size_t>(start - arena), region.getRange()});
+        }
+    });
+
+    std::sort(skipped.begin(), skipped.end(),
+            [](const SaveState::Span &lhs, const SaveState::Span &rhs) {
+                return lhs.offset < rhs.offset;
+            });
+
+    // Invert the skipped regions in place into the captured spans. The sentinel ends the last span
+    // at the end of the arena, and a span is only written once the region at its index was read.
+    skipped.push_back({memorySize, 0});
+
+    size_t cursor = 0;
+    size_t spanCount = 0;
+    state.m_dataSize = 0;
+
+    for (size_t i = 0; i < skipped.size(); ++i) {
+        size_t end = skipped[i].offset;
+        size_t next = skipped[i].offset + skipped[i].size;
+
+        if (end > cursor) {
+            memcpy(state.m_data + state.m_dataSize, arena + cursor, end - cursor);
+            state.m_spans[spanCount++] = {cursor, end - cursor};
+            state.m_dataSize += end - cursor;
+        }
+
+        cursor = next;
+    }
+
+    state.m_spans.resize(spanCount);
+    state.m_state = *this;
+    state.m_context = this;
+}
+
+/// @brief Restores the arena and the engine state from a snapshot.
+/// @details Every pointer into the arena, including the singletons, is invalidated by this call,
+/// unless it points to an object which also existed when the snapshot was taken. The archives
+/// mounted in the snapshot must still be mounted in the context, as the System::ArchiveCache
+/// reference counts are not part of the snapshot.
+/// @param state A snapshot taken from this context.
+void EngineContext::loadState(const SaveState &state) {
+    ASSERT(state.m_context == this);
+    ASSERT(state.m_capacity == memorySize);
+
+    auto *arena = reinterpret_cast<u8 *>(memorySpace);
+    const u8 *data = state.m_data;
+    for (const auto &span : state.m_spans) {
+        memcpy(arena + span.offset, data, span.size);
+        data += span.size;
+    }
+
+    static_cast<EngineState &>(*this) = state.m_state;
+}
+
+/// @brief Visits the free blocks of every heap which fills memory when allocating it.
+/// @details The contents of these blocks are never observed by the engine, so they need not be
+/// captured in a snapshot. Child heaps are used blocks of their parent, so the visited regions are
+/// disjoint, but they are not visited in address order.
+void EngineContext::visitFree(
+        const std::function<void(const Abstract::Memory::Region &)> &visitor) const {
+    Abstract::Memory::MEMList &heaps = const_cast<Abstract::Memory::MEMList &>(heapList);
+    for (void *node = heaps.getFirst(); node; node = heaps.getNext(node)) {
+        EGG::ExpHeap *heap = EGG::Heap::dynamicCastToExp(reinterpret_cast<EGG::Heap *>(node));
+        if (heap && heap->dynamicCastHandleToExp()->isAllocFilled()) {
+            heap->dynamicCastHandleToExp()->visitFree(visitor);
+        }
+    }
+}
+
+/// @brief Returns the context used by threads which have not bound their own.
+EngineContext *EngineContext::Default() {
+    return &s_defaultContext;
+}
+
+EngineContext EngineContext::s_defaultContext;
+
+thread_local EngineContext *EngineContext::s_current = &EngineContext::s_defaultContext;
+
+} // namespace Kinoko
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <abstract/memory/List.hh>
+
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <vector>
+
+namespace Abstract::Memory {
+struct Region;
+} // namespace Abstract::Memory
+
+namespace EGG {
+class Archive;
+class Heap;
+} // namespace EGG
+
+namespace Field {
+class BoxColManager;
+class CollisionDirector;
+class CourseColMgr;
+class ObjectDirector;
+class ObjectDrivableDirector;
+} // namespace Field
+
+namespace Item {
+class ItemDirector;
+} // namespace Item
+
+namespace Kart {
+enum class CalcStage : u8;
+class KartObjectManager;
+class KartObjectProxy;
+class KartParamFileManager;
+} // namespace Kart
+
+namespace System {
+class CourseMap;
+class KPadDirector;
+class RaceConfig;
+class RaceManager;
+class ResourceManager;
+} // namespace System
+
+namespace Kinoko {
+
+/// @brief Allocates from the system allocator rather than the engine heaps.
+/// @details Containers in the engine state use this allocator, so that copying the state into a
+/// SaveState never allocates from the arena being captured.
+template <typename T>
+struct SystemAllocator {
+    typedef T value_type;
+
+    SystemAllocator() = default;
+
+    template <typename U>
+    SystemAllocator(const SystemAllocator<U> &) {}
+
+    [[nodiscard]] T *allocate(size_t n) {
+        T *ptr = reinterpret_cast<T *>(std::malloc(n * sizeof(T)));
+        ASSERT(ptr);
+        return ptr;
+    }
+
+    void deallocate(T *ptr, size_t /* n */) {
+        std::free(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const SystemAllocator<U> &) const {
+        return true;
+    }
+};
+
+/// @brief The engine state outside of the arena which changes over the course of a race.
+/// @details Everything here is either a pointer into the arena or a copyable value, so the state
+/// can be captured and restored along with the arena. See EngineContext::saveState.
+struct EngineState {
+    typedef std::list<Kart::KartObjectProxy *, SystemAllocator<Kart::KartObjectProxy *>> ProxyList;
+    typedef std::list<EGG::Archive *, SystemAllocator<EGG::Archive *>> ArchiveList;
+
+    EngineState();
+
+    /*-------------*
+        Singletons
+     *-------------*/
+
+    System::ResourceManager *resourceManager;              ///< @addr{0x809BD738}
+    System::KPadDirector *kPadDirector;                    ///< @addr{0x809BD70C}
+    System::RaceConfig *raceConfig;                        ///< @addr{0x809BD728}
+    System::RaceManager *raceManager;                      ///< @addr{0x809BD730}
+    System::CourseMap *courseMap;                          ///< @addr{0x809BD6E8}
+    Kart::KartObjectManager *kartObjectManager;            ///< @addr{0x809C18F8}
+    Field::CollisionDirector *collisionDirector;           ///< @addr{0x809C2F44}
+    Field::CourseColMgr *courseColMgr;                     ///< @addr{0x809C3C10}
+    Field::BoxColManager *boxColManager;                   ///< @addr{0x809C2EF0}
+    Field::ObjectDirector *objectDirector;                 ///< @addr{0x809C4330}
+    Field::ObjectDrivableDirector *objectDrivableDirector; ///< @addr{0x809C4310}
+    Item::ItemDirector *itemDirector;                      ///< @addr{0x809C3618}
+
+    Kart::KartParamFileManager *kartParamFileManager;
+
+    ProxyList proxyList;     ///< @addr{0x809C1900}
+    ArchiveList archiveList; ///< The linked list of all mounted archives.
+
+    /// @brief Scratch space for the GJK simplex solver in ObjectCollisionBase.
+    std::array<std::array<f32, 4>, 4> dotProductCache;
+
+    /*-------*
+        Heap
+     *-------*/
+
+    Abstract::Memory::MEMList heapList; ///< @addr{0x80384320}
+    Abstract::Memory::MEMList rootList; ///< Heads of all heaps without a parent heap.
+    EGG::Heap *currentHeap;             ///< @addr{0x80386EA0}
+    EGG::Heap *allocatableHeap;         ///< @addr{0x80386EA8}
+    EGG::Heap *heapForCreateScene;      ///< The heap of the most recently created scene.
+    EGG::Heap *sceneRootHeap;           ///< The parent heap of the root scene.
+    EGG::Heap *rootHeap;
+};
+
+class EngineContext;
+
+/// @brief A snapshot of an engine context, taken with EngineContext::saveState.
+/// @details The snapshot can be restored any number of times. It can only be restored into the
+/// context it was taken from, as the arena is full of absolute pointers into itself.
+class SaveState {
+public:
+    SaveState();
+    ~SaveState();
+
+    SaveState(const SaveState &) = delete;
+    SaveState &operator=(const SaveState &) = delete;
+
+    /// @brief Whether the snapshot holds a state which can be loaded.
+    [[nodiscard]] bool isValid() const {
+        return m_context;
+    }
+
+    /// @brief The number of bytes of the arena held by the snapshot.
+    [[nodiscard]] size_t size() const {
+        return m_dataSize;
+    }
+
+private:
+    friend class EngineContext;
+
+    /// @brief A range of the arena which is captured, relative to the start of the arena.
+    struct Span {
+        size_t offset;
+        size_t size;
+    };
+
+    const EngineContext *m_context; ///< The context the snapshot was taken from.
+    EngineState m_state;
+    std::vector<Span, SystemAllocator<Span>> m_spans;
+    u8 *m_data;        ///< The contents of the spans, packed back to back.
+    size_t m_dataSize; ///< The sum of the sizes of the spans.
+    size_t m_capacity; ///< The size of the data buffer, which is the size of the arena.
+};
+
+/// @brief Owns the state of a single instance of the engine.
+/// @details The base game keeps its managers and heap bookkeeping in globals, which limits a
+/// process to one race at a time. In Kinoko, that state lives in a context instead, along with the
+/// memory arena the heaps are carved from. Engine code resolves the state through the context bound
+/// to the calling thread, so independent races can be simulated on separate threads. Threads which
+/// never bind a context share the default context, which matches the base game's behavior.
+class EngineContext : public EngineState {
+public:
+    EngineContext();
+    ~EngineContext();
+
+    void initMemory(size_t size);
+    EngineContext *bind();
+
+    void saveState(SaveState &state) const;
+    void loadState(const SaveState &state);
+    void visitFree(const std::function<void(const Abstract::Memory::Region &)> &visitor) const;
+
+    /// @brief Returns the context bound to the calling thread.
+    [[nodiscard]] static EngineContext *Current() {
+        return s_current;
+    }
+
+    [[nodiscard]] static EngineContext *Default();
+
+    /// @brief Initializes the race scenario, see RaceConfig::RegisterInitCallback.
+    std::function<void(System::RaceConfig *, void *)> raceConfigInitCallback;
+    /// @brief The argument sent into the callback. This is expected to be reinterpret_casted.
+    void *raceConfigInitCallbackArg;
+
+    /// @brief Runs at each CalcStage of every kart, see KartSub::RegisterStageCallback.
+    std::function<void(Kart::CalcStage, u8, void *)> kartStageCallback;
+    /// @brief The argument sent into the callback.
+    void *kartStageCallbackArg;
+
+    void *memorySpace; ///< The arena backing the root heap, owned by the context.
+    size_t memorySize;
+
+private:
+    static EngineContext s_defaultContext;
+    static thread_local EngineContext *s_current;
+};
+
+} // namespace Kinoko
@@ -1,5 +1,7 @@
 #include "egg/core/ExpHeap.hh"
 
+#include "egg/core/EngineContext.hh"
+
 using namespace Abstract::Memory;
 
 namespace EGG {
@@ -11,12 +13,12 @@ Heap::Heap(MEMiHeapHead *handle) : m_handle(handle), m_children(Disposer::getLin
     m_name = "NoName";
     m_flags.makeAllZero();
 
-    s_heapList.append(this);
+    Kinoko::EngineContext::Current()->heapList.append(this);
 }
 
 /// @addr{0x80229780}
 Heap::~Heap() {
-    s_heapList.remove(this);
+    Kinoko::EngineContext::Current()->heapList.remove(this);
 }
 
 /// @addr{0x80229C5C}
@@ -50,15 +52,17 @@ void Heap::removeDisposer(Disposer *disposer) {
 }
 
 Heap *Heap::becomeAllocatableHeap() {
-    Heap *oldHeap = s_allocatableHeap;
-    s_allocatableHeap = this;
+    auto *context = Kinoko::EngineContext::Current();
+    Heap *oldHeap = context->allocatableHeap;
+    context->allocatableHeap = this;
     return oldHeap;
 }
 
 /// @addr{0x80229D74}
 Heap *Heap::becomeCurrentHeap() {
-    Heap *oldHeap = s_currentHeap;
-    s_currentHeap = this;
+    auto *context = Kinoko::EngineContext::Current();
+    Heap *oldHeap = context->currentHeap;
+    context->currentHeap = this;
     return oldHeap;
 }
 
@@ -93,16 +97,18 @@ void Heap::setParentHeap(Heap *heap) {
 
 /// @addr{0x80229814}
 void *Heap::alloc(size_t size, int align, Heap *pHeap) {
-    Heap *currentHeap = s_currentHeap;
+    auto *context = Kinoko::EngineContext::Current();
+    Heap *currentHeap = context->currentHeap;
+    Heap *allocatableHeap = context->allocatableHeap;
 
-    if (s_allocatableHeap) {
+    if (allocatableHeap) {
         if (currentHeap && !pHeap) {
             pHeap = currentHeap;
         }
 
-        if (pHeap != s_allocatableHeap) {
+        if (pHeap != allocatableHeap) {
             WARN("HEAP ALLOC FAIL (%p, %s): Allocatable heap is %p (%s)", pHeap, pHeap->getName(),
-                    s_allocatableHeap, s_allocatableHeap->getName());
+                    allocatableHeap, allocatableHeap->getName());
 
             return nullptr;
         }
@@ -158,8 +164,10 @@ void Heap::free(void *block, Heap *pHeap) {
 }
 
 Heap *Heap::findHeap(MEMiHeapHead *handle) {
+    MEMList &heapList = Kinoko::EngineContext::Current()->heapList;
+
     Heap *node = nullptr;
-    while ((node = reinterpret_cast<Heap *>(s_heapList.getNext(node)))) {
+    while ((node = reinterpret_cast<Heap *>(heapList.getNext(node)))) {
         if (node->m_handle == handle) {
             return node;
         }
@@ -179,7 +187,7 @@ ExpHeap *Heap::dynamicCastToExp(Heap *heap) {
 }
 
 Heap *Heap::getCurrentHeap() {
-    return s_currentHeap;
+    return Kinoko::EngineContext::Current()->currentHeap;
 }
 
 } // namespace EGG
@@ -231,8 +239,3 @@ void operator delete[](void *block) noexcept {
 void operator delete[](void *block, size_t /* size */) noexcept {
     EGG::Heap::free(block, nullptr);
 }
-
-MEMList EGG::Heap::s_heapList = MEMList(EGG::Heap::getOffset()); ///< @addr{0x80384320}
-
-EGG::Heap *EGG::Heap::s_currentHeap = nullptr;     ///< @addr{0x80386EA0}
-EGG::Heap *EGG::Heap::s_allocatableHeap = nullptr; ///< @addr{0x80386EA8}
@@ -82,11 +82,6 @@ protected:
     Abstract::Memory::MEMLink m_link;
     Abstract::Memory::MEMList m_children;
     const char *m_name;
-
-    static Abstract::Memory::MEMList s_heapList;
-
-    static Heap *s_currentHeap;
-    static Heap *s_allocatableHeap;
 };
 
 } // namespace EGG
@@ -1,5 +1,6 @@
 #include "SceneManager.hh"
 
+#include "egg/core/EngineContext.hh"
 #include "egg/core/ExpHeap.hh"
 
 namespace EGG {
@@ -48,7 +49,7 @@ void SceneManager::createChildScene(int id, Scene *parent) {
 
 /// @addr{0x8023B0E4}
 void SceneManager::createScene(int id, Scene *parent) {
-    Heap *parentHeap = parent ? parent->heap() : s_rootHeap;
+    Heap *parentHeap = parent ? parent->heap() : RootHeap();
 
     // We need to preserve the locked status to reinstate it later
     bool locked = parentHeap->tstDisableAllocation();
@@ -57,7 +58,7 @@ void SceneManager::createScene(int id, Scene *parent) {
     }
 
     ExpHeap *newHeap = ExpHeap::create(-1, parentHeap, s_heapOptionFlg);
-    s_heapForCreateScene = newHeap;
+    Kinoko::EngineContext::Current()->heapForCreateScene = newHeap;
 
     if (locked) {
         parentHeap->disableAllocation();
@@ -96,7 +97,7 @@ void SceneManager::destroyScene(Scene *scene) {
     }
 
     scene->heap()->destroy();
-    Heap *parentHeap = parent ? parent->heap() : s_rootHeap;
+    Heap *parentHeap = parent ? parent->heap() : RootHeap();
     parentHeap->becomeCurrentHeap();
 }
 
@@ -207,9 +208,18 @@ void SceneManager::setupNextSceneId() {
     m_nextSceneId = -1;
 }
 
-Heap *SceneManager::s_heapForCreateScene = nullptr;
-u16 SceneManager::s_heapOptionFlg = 2;
+Heap *SceneManager::heapForCreateScene() {
+    return Kinoko::EngineContext::Current()->heapForCreateScene;
+}
+
+Heap *SceneManager::RootHeap() {
+    return Kinoko::EngineContext::Current()->sceneRootHeap;
+}
 
-Heap *SceneManager::s_rootHeap = nullptr;
+void SceneManager::SetRootHeap(Heap *heap) {
+    Kinoko::EngineContext::Current()->sceneRootHeap = heap;
+}
+
+u16 SceneManager::s_heapOptionFlg = 2;
 
 } // namespace EGG
@@ -54,9 +54,8 @@ public:
         return m_currentSceneId;
     }
 
-    [[nodiscard]] static Heap *heapForCreateScene() {
-        return s_heapForCreateScene;
-    }
+    [[nodiscard]] static Heap *heapForCreateScene();
+    [[nodiscard]] static Heap *RootHeap();
 
     /*----------*
         Setters
@@ -66,9 +65,7 @@ public:
         m_nextSceneId = id;
     }
 
-    static void SetRootHeap(Heap *heap) {
-        s_rootHeap = heap;
-    }
+    static void SetRootHeap(Heap *heap);
 
 private:
     /*----------*
@@ -81,10 +78,7 @@ private:
     int m_currentSceneId;
     int m_prevSceneId;
 
-    static Heap *s_heapForCreateScene;
     static u16 s_heapOptionFlg;
-
-    static Heap *s_rootHeap;
 };
 
 } // namespace EGG
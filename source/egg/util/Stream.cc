@@ -1,7 +1,85 @@
 #include "Stream.hh"
 
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define STREAM_SHUFFLE_SSSE3
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(__arm64__)
+#define STREAM_SHUFFLE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace EGG {
 
+/// @brief The largest structure which RamStream::read_structs can byteswap.
+static constexpr size_t MAX_STRUCT_SIZE = 64;
+
+#ifdef STREAM_SHUFFLE_SSSE3
+__attribute__((target("ssse3"))) static void ShuffleBlocksSSSE3(u8 *data, size_t blocks,
+        const u8 *mask) {
+    __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask));
+    for (size_t i = 0; i < blocks; ++i) {
+        auto *block = reinterpret_cast<__m128i *>(data + i * 16);
+        _mm_storeu_si128(block, _mm_shuffle_epi8(_mm_loadu_si128(block), shuffle));
+    }
+}
+#endif
+
+/// @brief Permutes the bytes of each 16-byte block with a single shuffle instruction.
+/// @param mask For each byte of a block, the index of the byte to take its value from.
+/// @return Whether the blocks were shuffled, which is not the case without SIMD support.
+static bool ShuffleBlocks(u8 *data, size_t blocks, const u8 *mask) {
+#if defined(STREAM_SHUFFLE_SSSE3)
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    if (!supported) {
+        return false;
+    }
+
+    ShuffleBlocksSSSE3(data, blocks, mask);
+    return true;
+#elif defined(STREAM_SHUFFLE_NEON)
+    uint8x16_t shuffle = vld1q_u8(mask);
+    for (size_t i = 0; i < blocks; ++i) {
+        u8 *block = data + i * 16;
+        vst1q_u8(block, vqtbl1q_u8(vld1q_u8(block), shuffle));
+    }
+    return true;
+#else
+    (void)data;
+    (void)blocks;
+    (void)mask;
+    return false;
+#endif
+}
+
+/// @brief Permutes the bytes of each unit of the given size.
+/// @details Where the unit size divides 16, the data is shuffled a block at a time with SIMD, and
+/// only the remainder is permuted a byte at a time.
+/// @param permutation For each byte of a unit, the index of the byte to take its value from.
+static void Permute(u8 *data, size_t size, const u8 *permutation, size_t unitSize) {
+    size_t done = 0;
+
+    if (16 % unitSize == 0) {
+        u8 mask[16];
+        for (size_t i = 0; i < 16; ++i) {
+            mask[i] = i - i % unitSize + permutation[i % unitSize];
+        }
+
+        if (ShuffleBlocks(data, size / 16, mask)) {
+            done = size - size % 16;
+        }
+    }
+
+    u8 unit[MAX_STRUCT_SIZE];
+    for (; done < size; done += unitSize) {
+        memcpy(unit, data + done, unitSize);
+        for (size_t i = 0; i < unitSize; ++i) {
+            data[done + i] = unit[permutation[i]];
+        }
+    }
+}
+
 Stream::Stream() : m_endian(std::endian::big), m_index(0) {}
 
 Stream::~Stream() = default;
@@ -111,6 +189,56 @@ u8 *RamStream::dataAtIndex() {
     return m_buffer + m_index;
 }
 
+/// @brief Copies bytes out of the stream, checking the bounds once for all of them.
+void RamStream::readBulk(void *output, size_t size) {
+    ASSERT(m_index + size <= m_size);
+    memcpy(output, m_buffer + m_index, size);
+    m_index += size;
+}
+
+/// @brief Byteswaps an array of values of the given size.
+void RamStream::ByteswapArray(void *data, size_t count, size_t size) {
+    if (size == 1) {
+        return;
+    }
+
+    ASSERT(size == 2 || size == 4 || size == 8);
+
+    u8 permutation[8];
+    for (size_t i = 0; i < size; ++i) {
+        permutation[i] = size - 1 - i;
+    }
+
+    Permute(reinterpret_cast<u8 *>(data), count * size, permutation, size);
+}
+
+/// @brief Byteswaps each field of an array of structures.
+/// @param layout The size of each field of the structure, in order.
+void RamStream::ByteswapStructs(void *data, size_t count, std::span<const u8> layout) {
+    // Structures of a single type of field are just an array of that type
+    bool uniform = true;
+    for (u8 fieldSize : layout) {
+        uniform = uniform && fieldSize == layout[0];
+    }
+
+    if (uniform) {
+        ByteswapArray(data, count * layout.size(), layout[0]);
+        return;
+    }
+
+    u8 permutation[MAX_STRUCT_SIZE];
+    size_t structSize = 0;
+    for (u8 fieldSize : layout) {
+        ASSERT(structSize + fieldSize <= MAX_STRUCT_SIZE);
+        for (size_t i = 0; i < fieldSize; ++i) {
+            permutation[structSize + i] = structSize + fieldSize - 1 - i;
+        }
+        structSize += fieldSize;
+    }
+
+    Permute(reinterpret_cast<u8 *>(data), count * structSize, permutation, structSize);
+}
+
 /// @brief Splits the current stream into two.
 /// @details Segments the current stream at the current index. The returned stream is the data from
 /// the current index to size bytes after. The current stream is then moved to `size` bytes after
@@ -2,6 +2,7 @@
 
 #include <Common.hh>
 
+#include <span>
 #include <string>
 
 namespace EGG {
@@ -71,7 +72,40 @@ public:
     [[nodiscard]] u8 *data();
     [[nodiscard]] u8 *dataAtIndex();
 
+    /// @brief Reads consecutive values into an array.
+    /// @details Unlike reading the values one at a time, the bounds are checked once, and the
+    /// values are copied and then byteswapped in bulk.
+    template <ParseableType T>
+    void read_array(std::span<T> output) {
+        readBulk(output.data(), output.size_bytes());
+
+        if (m_endian != std::endian::native) {
+            ByteswapArray(output.data(), output.size(), sizeof(T));
+        }
+    }
+
+    /// @brief Reads consecutive structures into an array, like read_array.
+    /// @tparam T The structure, which must consist of exactly the given fields, without padding.
+    /// @tparam Fields The types of the structure's fields, in order, which determine how each
+    /// structure is byteswapped.
+    template <typename T, ParseableType... Fields>
+    void read_structs(std::span<T> output) {
+        STATIC_ASSERT((sizeof(Fields) + ...) == sizeof(T));
+        static constexpr std::array<u8, sizeof...(Fields)> LAYOUT = {sizeof(Fields)...};
+
+        readBulk(output.data(), output.size_bytes());
+
+        if (m_endian != std::endian::native) {
+            ByteswapStructs(output.data(), output.size(), LAYOUT);
+        }
+    }
+
 private:
+    void readBulk(void *output, size_t size);
+
+    static void ByteswapArray(void *data, size_t count, size_t size);
+    static void ByteswapStructs(void *data, size_t count, std::span<const u8> layout);
+
     u8 *m_buffer;
     u32 m_size;
 };
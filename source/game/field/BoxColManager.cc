@@ -3,6 +3,8 @@
 #include "game/field/obj/ObjectCollidable.hh"
 #include "game/field/obj/ObjectDrivable.hh"
 
+#include <egg/core/EngineContext.hh>
+
 #include <numeric>
 
 namespace Field {
@@ -70,8 +72,9 @@ BoxColManager::BoxColManager() {
 
 /// @addr{0x807854E4}
 BoxColManager::~BoxColManager() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->boxColManager) {
+        context->boxColManager = nullptr;
         WARN("BoxColManager instance not explicitly handled!");
     }
 }
@@ -261,21 +264,23 @@ void BoxColManager::search(f32 radius, const EGG::Vector3f &pos, const BoxColFla
 
 /// @addr{0x807855DC}
 BoxColManager *BoxColManager::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new BoxColManager;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->boxColManager);
+    context->boxColManager = new BoxColManager;
+    return context->boxColManager;
 }
 
 /// @addr{0x8078562C}
 void BoxColManager::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->boxColManager);
+    auto *instance = context->boxColManager;
+    context->boxColManager = nullptr;
     delete instance;
 }
 
 BoxColManager *BoxColManager::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->boxColManager;
 }
 
 /// @brief Helper function since the getters share all code except the flag.
@@ -598,6 +603,4 @@ void BoxColManager::searchImpl(f32 radius, const EGG::Vector3f &pos, const BoxCo
     }
 }
 
-BoxColManager *BoxColManager::s_instance = nullptr; ///< @addr{0x809C2EF0}
-
 } // namespace Field
@@ -120,8 +120,6 @@ private:
     EGG::Vector3f m_cachePoint;
     f32 m_cacheRadius;
     BoxColFlag m_cacheFlag;
-
-    static BoxColManager *s_instance;
 };
 
 } // namespace Field
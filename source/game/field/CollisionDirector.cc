@@ -2,6 +2,8 @@
 
 #include "game/field/ObjectDrivableDirector.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace Field {
 
 /// @addr{0x8078E4F0}
@@ -296,20 +298,22 @@ const CollisionDirector::CollisionEntry *CollisionDirector::closestCollisionEntr
 
 /// @addr{0x8078DFE8}
 CollisionDirector *CollisionDirector::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new CollisionDirector;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->collisionDirector);
+    context->collisionDirector = new CollisionDirector;
+    return context->collisionDirector;
 }
 
 CollisionDirector *CollisionDirector::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->collisionDirector;
 }
 
 /// @addr{0x8078E124}
 void CollisionDirector::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->collisionDirector);
+    auto *instance = context->collisionDirector;
+    context->collisionDirector = nullptr;
     delete instance;
 }
 
@@ -322,14 +326,13 @@ CollisionDirector::CollisionDirector() {
 
 /// @addr{0x8078E454}
 CollisionDirector::~CollisionDirector() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->collisionDirector) {
+        context->collisionDirector = nullptr;
         WARN("CollisionDirector instance not explicitly handled!");
     }
 
     CourseColMgr::DestroyInstance();
 }
 
-CollisionDirector *CollisionDirector::s_instance = nullptr; ///< @addr{0x809C2F44}
-
 } // namespace Field
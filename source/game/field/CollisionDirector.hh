@@ -78,8 +78,6 @@ private:
     const CollisionEntry *m_closestCollisionEntry;
     std::array<CollisionEntry, COLLISION_ARR_LENGTH> m_entries;
     size_t m_collisionEntryCount;
-
-    static CollisionDirector *s_instance; ///< @addr{0x809C2F44}
 };
 
 } // namespace Field
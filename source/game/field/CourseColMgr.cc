@@ -4,6 +4,8 @@
 
 #include "game/system/ResourceManager.hh"
 
+#include <egg/core/EngineContext.hh>
+
 // Credit: em-eight/mkw
 
 namespace Field {
@@ -149,28 +151,30 @@ CourseColMgr::NoBounceWallColInfo *CourseColMgr::noBounceWallInfo() const {
 }
 
 /// @brief Loads a particular section of a .szs file
-void *CourseColMgr::LoadFile(const char *filename) {
+void *CourseColMgr::LoadFile(const EGG::Archive::Path &filename) {
     auto *resMgr = System::ResourceManager::Instance();
     return resMgr->getFile(filename, nullptr, System::ArchiveId::Course);
 }
 
 /// @addr{0x807C2824}
 CourseColMgr *CourseColMgr::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new CourseColMgr;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->courseColMgr);
+    context->courseColMgr = new CourseColMgr;
+    return context->courseColMgr;
 }
 
 /// @addr{0x807C2884}
 void CourseColMgr::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->courseColMgr);
+    auto *instance = context->courseColMgr;
+    context->courseColMgr = nullptr;
     delete instance;
 }
 
 CourseColMgr *CourseColMgr::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->courseColMgr;
 }
 
 /// @addr{0x807C29E4}
@@ -179,8 +183,9 @@ CourseColMgr::CourseColMgr()
 
 /// @addr{0x807C2A04}
 CourseColMgr::~CourseColMgr() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->courseColMgr) {
+        context->courseColMgr = nullptr;
         WARN("CourseColMgr instance not explicitly handled!");
     }
 
@@ -402,6 +407,4 @@ void CollisionInfo::update(f32 now_dist, const EGG::Vector3f &offset,
     }
 }
 
-CourseColMgr *CourseColMgr::s_instance = nullptr; ///< @addr{0x809C3C10}
-
 } // namespace Field
@@ -3,6 +3,7 @@
 #include "game/field/KColData.hh"
 #include "game/field/obj/ObjectDrivable.hh"
 
+#include <egg/core/Archive.hh>
 #include <egg/math/BoundBox.hh>
 #include <egg/math/Matrix.hh>
 
@@ -59,7 +60,7 @@ public:
     [[nodiscard]] NoBounceWallColInfo *noBounceWallInfo() const;
     /// @endGetters
 
-    static void *LoadFile(const char *filename);
+    static void *LoadFile(const EGG::Archive::Path &filename);
 
     static CourseColMgr *CreateInstance();
     static void DestroyInstance();
@@ -84,8 +85,6 @@ private:
     f32 m_kclScale;
     NoBounceWallColInfo *m_noBounceWallInfo;
     EGG::Matrix34f *m_localMtx;
-
-    static CourseColMgr *s_instance; ///< @addr{0x809C3C10}
 };
 
 } // namespace Field
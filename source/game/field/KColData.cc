@@ -1,15 +1,122 @@
 #include "KColData.hh"
 
+#include "game/field/KColDataCache.hh"
+
 #include <egg/geom/Sphere.hh>
 #include <egg/math/Math.hh>
 
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KCOL_BATCH_AVX2
+#include <immintrin.h>
+#endif
 
 // Credit: em-eight/mkw
 // Credit: stblr/Hanachan
 
 namespace Field {
 
+#ifdef KCOL_BATCH_AVX2
+/// @brief The number of prisms whose rejection tests are evaluated at once.
+static constexpr size_t BATCH_SIZE = 4;
+
+/// @brief Computes Vector3f::ps_dot for four pairs of vectors at once, with identical rounding.
+/// @details Mathf::fma widens its operands to doubles, so the fused step is done in double lanes.
+/// Its force25Bit rounding is skipped, because it never changes a double widened from a float.
+/// NOTE: The target must not enable FMA, or the compiler could fuse the single-precision steps.
+__attribute__((target("avx2"))) static inline __m128 PsDot4(__m128 x, __m128 y, __m128 z,
+        __m128 rhsX, __m128 rhsY, __m128 rhsZ) {
+    __m128 y_ = _mm_mul_ps(y, rhsY);
+    __m256d xy = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(x), _mm256_cvtps_pd(rhsX)),
+            _mm256_cvtps_pd(y_));
+    return _mm_add_ps(_mm256_cvtpd_ps(xy), _mm_mul_ps(z, rhsZ));
+}
+
+/// @brief Evaluates the rejection tests of KColData::checkCollision for a batch of prisms.
+/// @details These are the attribute, edge and plane tests, which reject almost every prism of a
+/// block. The comparisons are negated like in the scalar code, so that NaNs are not rejected.
+/// @param prismArray The prism indices of the batch, as stored in the block data.
+/// @param count The number of prisms in the batch, up to BATCH_SIZE.
+/// @param typeDistance The maximum depth of a collision, which depends on the check type.
+/// @return A mask of the prisms which pass all of the tests, with bit i set for prism i.
+__attribute__((target("avx2"))) static u32 FilterPrismsAVX2(const u16 *prismArray, size_t count,
+        std::span<const KColData::KCollisionPrism> prisms,
+        std::span<const KColData::PrismRecord> records, std::span<const EGG::Vector3f> nrms,
+        std::span<const EGG::Vector3f> vertices, const EGG::Vector3f &pos, f32 radius,
+        f32 typeDistance, KCLTypeMask typeMask) {
+    alignas(16) f32 lanes[16][BATCH_SIZE] = {};
+    u32 active = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        u16 idx = parse<u16>(prismArray[i]);
+        const EGG::Vector3f *vecs[5];
+        f32 height;
+        u16 attribute;
+
+        if (!records.empty()) {
+            const auto &record = records[idx];
+            vecs[0] = &record.pos;
+            vecs[1] = &record.enrm1;
+            vecs[2] = &record.enrm2;
+            vecs[3] = &record.enrm3;
+            vecs[4] = &record.fnrm;
+            height = record.height;
+            attribute = record.attribute;
+        } else {
+            const auto &prism = prisms[idx];
+            vecs[0] = &vertices[prism.pos_i];
+            vecs[1] = &nrms[prism.enrm1_i];
+            vecs[2] = &nrms[prism.enrm2_i];
+            vecs[3] = &nrms[prism.enrm3_i];
+            vecs[4] = &nrms[prism.fnrm_i];
+            height = prism.height;
+            attribute = prism.attribute;
+        }
+
+        if (!(KCL_ATTRIBUTE_TYPE_BIT(attribute) & typeMask)) {
+            continue;
+        }
+
+        active |= 1 << i;
+
+        for (size_t j = 0; j < 5; ++j) {
+            lanes[j * 3 + 0][i] = vecs[j]->x;
+            lanes[j * 3 + 1][i] = vecs[j]->y;
+            lanes[j * 3 + 2][i] = vecs[j]->z;
+        }
+        lanes[15][i] = height;
+    }
+
+    if (active == 0) {
+        return 0;
+    }
+
+    auto load = [&](size_t idx) { return _mm_load_ps(lanes[idx]); };
+
+    const __m128 radiusV = _mm_set1_ps(radius);
+    const __m128 relX = _mm_sub_ps(_mm_set1_ps(pos.x), load(0));
+    const __m128 relY = _mm_sub_ps(_mm_set1_ps(pos.y), load(1));
+    const __m128 relZ = _mm_sub_ps(_mm_set1_ps(pos.z), load(2));
+
+    __m128 distCa = PsDot4(relX, relY, relZ, load(3), load(4), load(5));
+    __m128 distAb = PsDot4(relX, relY, relZ, load(6), load(7), load(8));
+    __m128 distBc = _mm_sub_ps(PsDot4(relX, relY, relZ, load(9), load(10), load(11)), load(15));
+    __m128 planeDist = PsDot4(relX, relY, relZ, load(12), load(13), load(14));
+    __m128 distInPlane = _mm_sub_ps(radiusV, planeDist);
+
+    __m128 pass = _mm_cmp_ps(radiusV, distCa, _CMP_NLE_UQ);
+    pass = _mm_and_ps(pass, _mm_cmp_ps(radiusV, distAb, _CMP_NLE_UQ));
+    pass = _mm_and_ps(pass, _mm_cmp_ps(radiusV, distBc, _CMP_NLE_UQ));
+    pass = _mm_and_ps(pass, _mm_cmp_ps(distInPlane, _mm_setzero_ps(), _CMP_NLE_UQ));
+    pass = _mm_and_ps(pass, _mm_cmp_ps(distInPlane, _mm_set1_ps(typeDistance), _CMP_NGE_UQ));
+
+    return static_cast<u32>(_mm_movemask_ps(pass)) & active;
+}
+#endif
+
 /// @addr{0x807BDC5C}
 KColData::KColData(const void *file) {
     auto addOffset = [](const void *file, u32 offset) -> const void * {
@@ -44,14 +151,54 @@ KColData::KColData(const void *file) {
     m_radius = 0.0f;
     m_prismIter = nullptr;
     m_cachedPrismArray = m_prismCache.data() - 1;
+    m_gridBlocks = nullptr;
+    m_gridCells = nullptr;
+    m_blockTypeMasks = nullptr;
+    m_blockListsOffset = 0;
+    m_blockListsCount = 0;
+    m_prismCacheTypeMask = 0;
+    m_prismCacheStamps = nullptr;
+    m_prismCacheGeneration = 0;
 
     // NOTE: Collision is expensive on the CPU, so we preload all of the prism data to ensure we're
     // not constantly handling endianness.
-    preloadPrisms();
-    preloadNormals();
-    preloadVertices();
+    if (!KColDataCache::Restore(file, m_prisms, m_nrms, m_vertices, m_bbox)) {
+        ArrayCounts counts = CountArrays(file);
+        m_prisms = std::span<KCollisionPrism>(new KCollisionPrism[counts.prisms], counts.prisms);
+        m_nrms = std::span<EGG::Vector3f>(new EGG::Vector3f[counts.nrms], counts.nrms);
+        m_vertices = std::span<EGG::Vector3f>(new EGG::Vector3f[counts.vertices],
+                counts.vertices);
+
+        // If the arrays were already preloaded on a worker thread, they only need to be copied
+        if (!KColDataCache::TakePrefetched(file, m_prisms, m_nrms, m_vertices)) {
+            Preload(file, m_prisms, m_nrms, m_vertices);
+        }
+
+        computeBBox();
+
+        KColDataCache::Store(file, m_prisms, m_nrms, m_vertices, m_bbox);
+    }
+
+    if (s_prismRecords) {
+        buildPrismRecords();
+    }
 
-    computeBBox();
+    buildBlockTypeMasks();
+
+    // The stamps change during the race, so they live on the heap to be saved with the engine state
+    m_prismCacheStamps = new u32[m_prisms.size()];
+    memset(m_prismCacheStamps, 0, m_prisms.size() * sizeof(u32));
+
+    if (s_blockGridBudget > 0) {
+        buildBlockGrid();
+    }
+}
+
+KColData::~KColData() {
+    // The block grid is allocated outside of the heaps, as it can be larger than them
+    free(m_gridBlocks);
+    free(m_blockTypeMasks);
+    delete[] m_prismCacheStamps;
 }
 
 /// @addr{0x807C24C0}
@@ -62,9 +209,17 @@ void KColData::narrowScopeLocal(const EGG::Vector3f &pos, f32 radius, KCLTypeMas
     m_typeMask = mask;
     m_cachedPos = pos;
     m_cachedRadius = radius;
+    m_prismCacheTypeMask = 0;
+
+    // Kinoko addition: Empty the set of cached prisms. Stamps are only reset once the generation
+    // wraps around.
+    if (++m_prismCacheGeneration == 0) {
+        memset(m_prismCacheStamps, 0, m_prisms.size() * sizeof(u32));
+        m_prismCacheGeneration = 1;
+    }
 
     if (radius <= m_sphereRadius) {
-        narrowPolygon_EachBlock(searchBlock(pos));
+        narrowPolygon_EachBlock(searchBlockOfType(pos, mask));
     }
 
     *m_prismCacheTop = 0;
@@ -79,8 +234,14 @@ void KColData::narrowPolygon_EachBlock(const u16 *prismArray) {
         /// so do not parse out the prism index and directly store it in the cache.
         *(m_prismCacheTop++) = *m_prismIter;
 
+        // Kinoko addition: Track the types in the cache, so that lookupSphereCached can skip it
+        u16 idx = parse<u16>(*m_prismIter);
+        m_prismCacheTypeMask |= KCL_ATTRIBUTE_TYPE_BIT(m_prisms[idx].attribute);
+        m_prismCacheStamps[idx] = m_prismCacheGeneration;
+
         if (m_prismCacheTop == m_prismCache.end()) {
             --m_prismCacheTop;
+            m_prismCacheStamps[idx] = 0;
             return;
         }
     }
@@ -131,8 +292,8 @@ bool KColData::checkSphere(f32 *distOut, EGG::Vector3f *fnrmOut, u16 *flagsOut)
     }
 
     // Check collision for all triangles, and continuously call the function until we're out
-    while (*++m_prismIter != 0) {
-        const KCollisionPrism &prism = m_prisms[parse<u16>(*m_prismIter)];
+    while (nextCandidate(CollisionCheckType::Plane)) {
+        const PrismRef prism = getPrism(parse<u16>(*m_prismIter));
         if (checkCollision(prism, distOut, fnrmOut, flagsOut, CollisionCheckType::Plane)) {
             return true;
         }
@@ -149,21 +310,15 @@ bool KColData::checkSphereSingle(f32 *distOut, EGG::Vector3f *fnrmOut, u16 *flag
         return false;
     }
 
-    while (*++m_prismIter != 0) {
-        if (m_prismCacheTop != m_prismCache.begin()) {
-            u16 *puVar10 = m_prismCacheTop - 1;
-            while (*m_prismIter != *puVar10) {
-                if (puVar10-- < m_prismCache.begin()) {
-                    break;
-                }
-            }
-
-            if (puVar10 >= m_prismCache.begin()) {
-                continue;
-            }
+    while (nextCandidate(CollisionCheckType::Edge)) {
+        // Skip prisms which are already in the cache. The base game scans the cache backwards,
+        // but Kinoko stamps each cached prism with the cache's generation instead.
+        u16 idx = parse<u16>(*m_prismIter);
+        if (m_prismCacheStamps[idx] == m_prismCacheGeneration) {
+            continue;
         }
 
-        const KCollisionPrism &prism = m_prisms[parse<u16>(*m_prismIter)];
+        const PrismRef prism = getPrism(idx);
         if (checkCollision(prism, distOut, fnrmOut, flagsOut, CollisionCheckType::Edge)) {
             return true;
         }
@@ -177,7 +332,7 @@ bool KColData::checkSphereSingle(f32 *distOut, EGG::Vector3f *fnrmOut, u16 *flag
 /// @addr{0x807C1BB4}
 void KColData::lookupSphere(f32 radius, const EGG::Vector3f &pos, const EGG::Vector3f &prevPos,
         KCLTypeMask typeMask) {
-    m_prismIter = searchBlock(pos);
+    m_prismIter = searchBlockOfType(pos, typeMask);
     m_pos = pos;
     m_prevPos = prevPos;
     m_movement = pos - prevPos;
@@ -192,11 +347,11 @@ void KColData::lookupSphereCached(const EGG::Vector3f &p1, const EGG::Vector3f &
     EGG::Sphere3f sphere2(m_cachedPos, m_cachedRadius);
 
     if (!sphere1.isInsideOtherSphere(sphere2)) {
-        m_prismIter = searchBlock(p1);
+        m_prismIter = searchBlockOfType(p1, typeMask);
         m_radius = std::min(m_sphereRadius, radius);
     } else {
         m_radius = radius;
-        m_prismIter = m_cachedPrismArray;
+        m_prismIter = m_prismCacheTypeMask & typeMask ? m_cachedPrismArray : nullptr;
     }
 
     m_pos = p1;
@@ -232,6 +387,24 @@ const u16 *KColData::searchBlock(const EGG::Vector3f &point) {
             (((u32)z >> shift) << m_areaXYBlocksShift | ((u32)y >> shift) << m_areaXBlocksShift |
                     (u32)x >> shift);
 
+    // Kinoko addition: If the block grid is built, look the leaf up without traversing the tree.
+    if (m_gridBlocks) {
+        const GridBlock &block = m_gridBlocks[index / 4];
+        u32 leafOffset = block.cells;
+
+        if (block.depth > 0) {
+            u32 cellShift = shift - block.depth;
+            u32 mask = (1 << block.depth) - 1;
+            u32 cellX = ((u32)x >> cellShift) & mask;
+            u32 cellY = ((u32)y >> cellShift) & mask;
+            u32 cellZ = ((u32)z >> cellShift) & mask;
+            leafOffset = m_gridCells[block.cells +
+                    ((cellZ << block.depth | cellY) << block.depth | cellX)];
+        }
+
+        return reinterpret_cast<const u16 *>(curBlock + leafOffset);
+    }
+
     while (true) {
         // Get the offset of the current node's child node.
         offset = parse<u32>(*reinterpret_cast<const u32 *>(curBlock + index));
@@ -257,6 +430,26 @@ const u16 *KColData::searchBlock(const EGG::Vector3f &point) {
     return reinterpret_cast<const u16 *>(curBlock + (offset & ~0x80000000));
 }
 
+/// @brief Finds the prism list at the given position, unless none of its prisms match the types.
+/// @details Kinoko addition. No prism of a skipped list would pass the type check of
+/// checkCollision, so the checks end exactly as if they had iterated the list.
+/// @return The prism list, or nullptr if there is none or its prisms don't match.
+const u16 *KColData::searchBlockOfType(const EGG::Vector3f &pos, KCLTypeMask typeMask) {
+    const u16 *prismArray = searchBlock(pos);
+    if (!prismArray || !m_blockTypeMasks) {
+        return prismArray;
+    }
+
+    const u16 *lists = reinterpret_cast<const u16 *>(
+            reinterpret_cast<const u8 *>(m_blockData) + m_blockListsOffset);
+    size_t idx = prismArray - lists;
+    if (idx < m_blockListsCount && !(m_blockTypeMasks[idx] & typeMask)) {
+        return nullptr;
+    }
+
+    return prismArray;
+}
+
 u16 KColData::prismCache(u32 idx) const {
     return m_prismCache[idx];
 }
@@ -280,68 +473,358 @@ EGG::Vector3f KColData::GetVertex(f32 height, const EGG::Vector3f &vertex1,
     return cross + vertex1;
 }
 
+/// @brief Makes every KColData constructed from now on build a record for each prism.
+/// @details Kinoko addition. A record holds everything a query reads about a prism, so it costs
+/// one or two cache lines instead of up to six scattered reads. This costs 80 bytes per prism on
+/// top of the preloaded arrays, which are still needed to compute the bounding box and to share
+/// through the KColDataCache.
+void KColData::EnablePrismRecords() {
+    s_prismRecords = true;
+}
+
+/// @brief Makes every KColData constructed from now on build a block grid, if it fits the budget.
+/// @details Kinoko addition. @see buildBlockGrid.
+/// @param budget The maximum size of a block grid in bytes, or 0 to traverse the octree instead.
+void KColData::SetBlockGridBudget(size_t budget) {
+    s_blockGridBudget = budget;
+}
+
+/// @brief Computes the sizes of the arrays preloaded from a KCL file.
+KColData::ArrayCounts KColData::CountArrays(const void *file) {
+    const auto *header = reinterpret_cast<const KColHeader *>(file);
+    u32 posOffset = parse<u32>(header->pos_data_offset);
+    u32 nrmOffset = parse<u32>(header->nrm_data_offset);
+    u32 prismOffset = parse<u32>(header->prism_data_offset);
+    u32 blockOffset = parse<u32>(header->block_data_offset);
+
+    ArrayCounts counts;
+    counts.prisms = (blockOffset - prismOffset) / sizeof(KCollisionPrism);
+    counts.nrms = (prismOffset + sizeof(KCollisionPrism) - nrmOffset) / sizeof(EGG::Vector3f);
+    counts.vertices = (nrmOffset - posOffset) / sizeof(EGG::Vector3f);
+    return counts;
+}
+
+/// @brief Byteswaps the prisms, normals and vertices of a KCL file into the given arrays.
+/// @details The arrays must be sized with CountArrays. This doesn't allocate, so it is safe to
+/// call from any thread.
+void KColData::Preload(const void *file, std::span<KCollisionPrism> prisms,
+        std::span<EGG::Vector3f> nrms, std::span<EGG::Vector3f> vertices) {
+    const auto *header = reinterpret_cast<const KColHeader *>(file);
+    const u8 *data = reinterpret_cast<const u8 *>(file);
+
+    PreloadPrisms(data + parse<u32>(header->prism_data_offset), prisms);
+    PreloadNormals(data + parse<u32>(header->nrm_data_offset), nrms);
+    PreloadVertices(data + parse<u32>(header->pos_data_offset), vertices);
+}
+
 /// @brief Creates a copy of the prisms in memory.
 /// @details Optimizes for time by copying all of the prisms to avoid constant byteswapping.
 /// Memory cost is typically upwards of a few hundred KB, with the worst case being ~1MB.
-void KColData::preloadPrisms() {
-    size_t prismCount =
-            (reinterpret_cast<uintptr_t>(m_blockData) - reinterpret_cast<uintptr_t>(m_prismData)) /
-            sizeof(KCollisionPrism);
-
-    u8 *unsafeData = reinterpret_cast<u8 *>(const_cast<void *>(m_prismData));
-    EGG::RamStream stream = EGG::RamStream(unsafeData, sizeof(KCollisionPrism) * prismCount);
-
-    m_prisms = std::span<KCollisionPrism>(new KCollisionPrism[prismCount], prismCount);
+void KColData::PreloadPrisms(const void *prismData, std::span<KCollisionPrism> prisms) {
+    u8 *unsafeData = reinterpret_cast<u8 *>(const_cast<void *>(prismData));
+    EGG::RamStream stream = EGG::RamStream(unsafeData, prisms.size_bytes());
 
     // Because the prisms are one-indexed, we insert an empty prism
     stream.skip(sizeof(KCollisionPrism));
 
-    for (size_t i = 1; i < prismCount; ++i) {
-        KCollisionPrism &prism = m_prisms[i];
-        prism.height = stream.read_f32();
-        prism.pos_i = stream.read_u16();
-        prism.fnrm_i = stream.read_u16();
-        prism.enrm1_i = stream.read_u16();
-        prism.enrm2_i = stream.read_u16();
-        prism.enrm3_i = stream.read_u16();
-        prism.attribute = stream.read_u16();
+    if (prisms.size() > 1) {
+        stream.read_structs<KCollisionPrism, f32, u16, u16, u16, u16, u16, u16>(
+                prisms.subspan(1));
     }
 }
 
 /// @brief Creates a copy of the normals in memory.
 /// @details Optimizes for time by copying all of the normals to avoid constant byteswapping.
 /// Memory cost is typically upwards of a few hundred KB, with the worst case being ~750KB.
-void KColData::preloadNormals() {
-    size_t normalCount = (reinterpret_cast<uintptr_t>(m_prismData) + sizeof(KCollisionPrism) -
-                                 reinterpret_cast<uintptr_t>(m_nrmData)) /
-            sizeof(EGG::Vector3f);
+void KColData::PreloadNormals(const void *nrmData, std::span<EGG::Vector3f> nrms) {
+    u8 *unsafeData = reinterpret_cast<u8 *>(const_cast<void *>(nrmData));
+    EGG::RamStream stream = EGG::RamStream(unsafeData, nrms.size_bytes());
+    stream.read_structs<EGG::Vector3f, f32, f32, f32>(nrms);
+}
 
-    m_nrms = std::span<EGG::Vector3f>(new EGG::Vector3f[normalCount], normalCount);
+/// @brief Creates a copy of the vertices in memory.
+/// @details Optimizes for time by copying all of the vertices to avoid constant byteswapping.
+/// Memory cost is typically upwards of a few hundred KB, with the worst case being ~750KB.
+void KColData::PreloadVertices(const void *posData, std::span<EGG::Vector3f> vertices) {
+    u8 *unsafeData = reinterpret_cast<u8 *>(const_cast<void *>(posData));
+    EGG::RamStream stream = EGG::RamStream(unsafeData, vertices.size_bytes());
+    stream.read_structs<EGG::Vector3f, f32, f32, f32>(vertices);
+}
 
-    u8 *unsafeData = reinterpret_cast<u8 *>(const_cast<void *>(m_nrmData));
-    EGG::RamStream stream = EGG::RamStream(unsafeData, sizeof(EGG::Vector3f) * normalCount);
+/// @brief Copies every prism's vertex and normals into a record of its own.
+/// @details Kinoko addition. The records are allocated on the current heap, like the arrays they
+/// are built from, and their memory cost is reported.
+void KColData::buildPrismRecords() {
+    m_prismRecords = std::span<PrismRecord>(new (64) PrismRecord[m_prisms.size()],
+            m_prisms.size());
 
-    for (auto &nrm : m_nrms) {
-        nrm.read(stream);
+    // Like the prisms, the records are one-indexed
+    for (size_t i = 1; i < m_prisms.size(); ++i) {
+        const auto &prism = m_prisms[i];
+        auto &record = m_prismRecords[i];
+        record.pos = m_vertices[prism.pos_i];
+        record.height = prism.height;
+        record.fnrm = m_nrms[prism.fnrm_i];
+        record.attribute = prism.attribute;
+        record.enrm1 = m_nrms[prism.enrm1_i];
+        record.enrm2 = m_nrms[prism.enrm2_i];
+        record.enrm3 = m_nrms[prism.enrm3_i];
     }
+
+    size_t indexedSize = m_prisms.size_bytes() + m_nrms.size_bytes() + m_vertices.size_bytes();
+    REPORT("Built %zu KCL prism records (%zu KB, in addition to %zu KB of indexed arrays)",
+            m_prismRecords.size(), m_prismRecords.size_bytes() / 1024, indexedSize / 1024);
 }
 
-/// @brief Creates a copy of the vertices in memory.
-/// @details Optimizes for time by copying all of the vertices to avoid constant byteswapping.
-/// Memory cost is typically upwards of a few hundred KB, with the worst case being ~750KB.
-void KColData::preloadVertices() {
-    size_t vertexCount =
-            (reinterpret_cast<uintptr_t>(m_nrmData) - reinterpret_cast<uintptr_t>(m_posData)) /
-            sizeof(EGG::Vector3f);
+/// @brief Computes the depth of the deepest leaf below an octree node.
+/// @param node The node containing the child to descend into.
+/// @param index The byte offset of the child in the node.
+static u32 GetBlockDepth(const u8 *node, u32 index) {
+    u32 offset = parse<u32>(*reinterpret_cast<const u32 *>(node + index));
+    if (offset & 0x80000000) {
+        return 0;
+    }
+
+    u32 depth = 0;
+    for (u32 i = 0; i < 8; ++i) {
+        depth = std::max(depth, GetBlockDepth(node + offset, 4 * i));
+    }
+
+    return depth + 1;
+}
+
+/// @brief Writes the leaf offsets of an octree node into the cells it covers.
+/// @param blockData The octree, from which the offsets are taken.
+/// @param node The node containing the child to descend into.
+/// @param index The byte offset of the child in the node.
+/// @param cells The cells of the root block, which are (1 << depth) wide in each dimension.
+/// @param size The width, in cells, of the cube of cells covered by the child.
+static void FillBlockCells(const u8 *blockData, const u8 *node, u32 index, u32 *cells, u32 depth,
+        u32 size, u32 cellX, u32 cellY, u32 cellZ) {
+    u32 offset = parse<u32>(*reinterpret_cast<const u32 *>(node + index));
+
+    if (offset & 0x80000000) {
+        u32 leafOffset = static_cast<u32>(node - blockData) + (offset & ~0x80000000);
+        for (u32 z = cellZ; z < cellZ + size; ++z) {
+            for (u32 y = cellY; y < cellY + size; ++y) {
+                for (u32 x = cellX; x < cellX + size; ++x) {
+                    cells[(z << depth | y) << depth | x] = leafOffset;
+                }
+            }
+        }
+
+        return;
+    }
+
+    size /= 2;
+    for (u32 i = 0; i < 8; ++i) {
+        FillBlockCells(blockData, node + offset, 4 * i, cells, depth, size,
+                cellX + (i & 1) * size, cellY + (i >> 1 & 1) * size, cellZ + (i >> 2) * size);
+    }
+}
+
+/// @brief Calls a function with the offset of every leaf below an octree node.
+/// @param node The node containing the child to descend into.
+/// @param index The byte offset of the child in the node.
+template <typename F>
+static void ForEachBlockLeaf(const u8 *blockData, const u8 *node, u32 index, F &&func) {
+    u32 offset = parse<u32>(*reinterpret_cast<const u32 *>(node + index));
+    if (offset & 0x80000000) {
+        func(static_cast<u32>(node - blockData) + (offset & ~0x80000000));
+        return;
+    }
+
+    for (u32 i = 0; i < 8; ++i) {
+        ForEachBlockLeaf(blockData, node + offset, 4 * i, func);
+    }
+}
 
-    m_vertices = std::span<EGG::Vector3f>(new EGG::Vector3f[vertexCount], vertexCount);
+/// @brief Computes the types of the prisms in each of the octree's prism lists.
+/// @details Kinoko addition. Queries usually only look for a few types, such as floors or walls, so
+/// searchBlockOfType uses these to skip the lists without any prism of those types. The masks are
+/// stored in a table covering the span of the lists, indexed by the position of each list.
+void KColData::buildBlockTypeMasks() {
+    const u8 *blockData = reinterpret_cast<const u8 *>(m_blockData);
+    u32 blocksZ = (~m_areaZWidthMask + 1) >> m_blockWidthShift;
+    u32 blockCount = blocksZ << m_areaXYBlocksShift;
+
+    // Lists start with an unused index, and end with a 0
+    auto listLength = [&](u32 leafOffset) {
+        const u16 *list = reinterpret_cast<const u16 *>(blockData + leafOffset);
+        u32 length = 1;
+        while (list[length] != 0) {
+            ++length;
+        }
+        return length + 1;
+    };
+
+    u32 start = UINT32_MAX;
+    u32 end = 0;
+    bool aligned = true;
+    for (u32 i = 0; i < blockCount; ++i) {
+        ForEachBlockLeaf(blockData, blockData, 4 * i, [&](u32 leafOffset) {
+            start = std::min(start, leafOffset);
+            end = std::max(end, leafOffset + 2 * listLength(leafOffset));
+            aligned &= leafOffset % 2 == 0;
+        });
+    }
+
+    if (start >= end || !aligned) {
+        return;
+    }
+
+    u32 count = (end - start) / 2;
+    auto *masks = reinterpret_cast<KCLTypeMask *>(calloc(count, sizeof(KCLTypeMask)));
+    if (!masks) {
+        return;
+    }
 
-    u8 *unsafeData = reinterpret_cast<u8 *>(const_cast<void *>(m_posData));
-    EGG::RamStream stream = EGG::RamStream(unsafeData, sizeof(EGG::Vector3f) * vertexCount);
+    for (u32 i = 0; i < blockCount; ++i) {
+        ForEachBlockLeaf(blockData, blockData, 4 * i, [&](u32 leafOffset) {
+            const u16 *list = reinterpret_cast<const u16 *>(blockData + leafOffset);
+            KCLTypeMask mask = 0;
+            for (const u16 *iter = list + 1; *iter != 0; ++iter) {
+                mask |= KCL_ATTRIBUTE_TYPE_BIT(m_prisms[parse<u16>(*iter)].attribute);
+            }
 
-    for (auto &vert : m_vertices) {
-        vert.read(stream);
+            masks[(leafOffset - start) / 2] = mask;
+        });
     }
+
+    m_blockTypeMasks = masks;
+    m_blockListsOffset = start;
+    m_blockListsCount = count;
+}
+
+/// @brief Flattens the octree into a grid, so that searchBlock can find a leaf without traversing
+/// the tree.
+/// @details Kinoko addition. Each root block of the octree gets a dense grid of cells as small as
+/// its deepest leaf, each holding the offset of the leaf containing it. Root blocks which are
+/// leaves themselves are stored without any cells. If the grid exceeds the budget, it is not
+/// built, and searchBlock keeps traversing the tree.
+void KColData::buildBlockGrid() {
+    const u8 *blockData = reinterpret_cast<const u8 *>(m_blockData);
+
+    u32 blocksZ = (~m_areaZWidthMask + 1) >> m_blockWidthShift;
+    size_t blockCount = static_cast<size_t>(blocksZ) << m_areaXYBlocksShift;
+    if (blockCount == 0) {
+        return;
+    }
+
+    auto *blocks = reinterpret_cast<GridBlock *>(malloc(blockCount * sizeof(GridBlock)));
+    if (!blocks) {
+        return;
+    }
+
+    // Cell indices are 32-bit, which allows for 10 levels below a root block
+    constexpr u32 MAX_GRID_DEPTH = 10;
+
+    // Size every block's cells first, so that the budget is checked before filling them
+    size_t cellCount = 0;
+    size_t size = blockCount * sizeof(GridBlock);
+    for (size_t i = 0; i < blockCount && size <= s_blockGridBudget; ++i) {
+        u32 depth = GetBlockDepth(blockData, 4 * i);
+        if (depth > m_blockWidthShift || depth > MAX_GRID_DEPTH) {
+            size = SIZE_MAX;
+            break;
+        }
+
+        blocks[i].depth = depth;
+        blocks[i].cells = depth == 0 ? 0 : static_cast<u32>(cellCount);
+
+        if (depth > 0) {
+            cellCount += static_cast<size_t>(1) << (3 * depth);
+            size += (static_cast<size_t>(1) << (3 * depth)) * sizeof(u32);
+        }
+    }
+
+    if (cellCount > UINT32_MAX || size > s_blockGridBudget) {
+        REPORT("Not building the KCL block grid, as it exceeds the budget of %zu KB",
+                s_blockGridBudget / 1024);
+        free(blocks);
+        return;
+    }
+
+    auto *grid = reinterpret_cast<u8 *>(realloc(blocks, size));
+    if (!grid) {
+        free(blocks);
+        return;
+    }
+
+    m_gridBlocks = reinterpret_cast<GridBlock *>(grid);
+    m_gridCells = reinterpret_cast<u32 *>(grid + blockCount * sizeof(GridBlock));
+
+    for (size_t i = 0; i < blockCount; ++i) {
+        GridBlock &block = m_gridBlocks[i];
+        if (block.depth == 0) {
+            u32 offset = parse<u32>(*reinterpret_cast<const u32 *>(blockData + 4 * i));
+            block.cells = offset & ~0x80000000;
+            continue;
+        }
+
+        FillBlockCells(blockData, blockData, 4 * i, m_gridCells + block.cells, block.depth,
+                1 << block.depth, 0, 0, 0);
+    }
+
+    REPORT("Built the KCL block grid (%zu blocks, %zu cells, %zu KB)", blockCount, cellCount,
+            size / 1024);
+}
+
+/// @brief Resolves a prism's fields, from its record if prism records are enabled.
+KColData::PrismRef KColData::getPrism(u16 idx) const {
+    if (!m_prismRecords.empty()) {
+        const PrismRecord &record = m_prismRecords[idx];
+        return PrismRef{&record.pos, &record.fnrm, &record.enrm1, &record.enrm2, &record.enrm3,
+                record.height, record.attribute};
+    }
+
+    const KCollisionPrism &prism = m_prisms[idx];
+    return PrismRef{&m_vertices[prism.pos_i], &m_nrms[prism.fnrm_i], &m_nrms[prism.enrm1_i],
+            &m_nrms[prism.enrm2_i], &m_nrms[prism.enrm3_i], prism.height, prism.attribute};
+}
+
+/// @brief Advances the prism iterator to the next prism which may collide.
+/// @details Kinoko addition. With AVX2, the rejection tests of checkCollision are evaluated for
+/// several prisms at once, and the prisms which fail them are skipped. Only the remaining ones are
+/// passed to checkCollision, which then resolves the edges and corners. Skipping a prism is safe,
+/// because checkCollision has no side effects when it fails. Without AVX2, every prism is visited.
+/// @return Whether a prism was found before the end of the list.
+bool KColData::nextCandidate(CollisionCheckType type) {
+#ifdef KCOL_BATCH_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    if (supported) {
+        f32 typeDistance = m_prismThickness;
+        if (type == CollisionCheckType::Edge) {
+            typeDistance += m_radius;
+        }
+
+        while (true) {
+            const u16 *batch = m_prismIter + 1;
+            size_t count = 0;
+            while (count < BATCH_SIZE && batch[count] != 0) {
+                ++count;
+            }
+
+            if (count == 0) {
+                m_prismIter = batch;
+                return false;
+            }
+
+            u32 mask = FilterPrismsAVX2(batch, count, m_prisms, m_prismRecords, m_nrms,
+                    m_vertices, m_pos, m_radius, typeDistance, m_typeMask);
+            if (mask != 0) {
+                m_prismIter = batch + std::countr_zero(mask);
+                return true;
+            }
+
+            m_prismIter = batch + count - 1;
+        }
+    }
+#else
+    (void)type;
+#endif
+
+    return *++m_prismIter != 0;
 }
 
 /// @brief This is a combination of the three collision checks in the base game.
@@ -349,7 +832,7 @@ void KColData::preloadVertices() {
 /// 1. A collision with at least the triangle edge (0x807C0F00)
 /// 2. A collision with the triangle plane (0x807C1514)
 /// 3. A collision such that we are inside the triangle (0x807C0884)
-bool KColData::checkCollision(const KCollisionPrism &prism, f32 *distOut, EGG::Vector3f *fnrmOut,
+bool KColData::checkCollision(const PrismRef &prism, f32 *distOut, EGG::Vector3f *fnrmOut,
         u16 *flagsOut, CollisionCheckType type) {
     // Responsible for updating the output params
     auto out = [&](f32 dist) {
@@ -357,7 +840,7 @@ bool KColData::checkCollision(const KCollisionPrism &prism, f32 *distOut, EGG::V
             *distOut = dist;
         }
         if (fnrmOut) {
-            *fnrmOut = m_nrms[prism.fnrm_i];
+            *fnrmOut = *prism.fnrm;
         }
         if (flagsOut) {
             *flagsOut = prism.attribute;
@@ -372,28 +855,28 @@ bool KColData::checkCollision(const KCollisionPrism &prism, f32 *distOut, EGG::V
         return false;
     }
 
-    const EGG::Vector3f relativePos = m_pos - m_vertices[prism.pos_i];
+    const EGG::Vector3f relativePos = m_pos - *prism.pos;
 
     // Edge normals point outside the triangle
-    const EGG::Vector3f &enrm1 = m_nrms[prism.enrm1_i];
+    const EGG::Vector3f &enrm1 = *prism.enrm1;
     f32 dist_ca = relativePos.ps_dot(enrm1);
     if (m_radius <= dist_ca) {
         return false;
     }
 
-    const EGG::Vector3f &enrm2 = m_nrms[prism.enrm2_i];
+    const EGG::Vector3f &enrm2 = *prism.enrm2;
     f32 dist_ab = relativePos.ps_dot(enrm2);
     if (m_radius <= dist_ab) {
         return false;
     }
 
-    const EGG::Vector3f &enrm3 = m_nrms[prism.enrm3_i];
+    const EGG::Vector3f &enrm3 = *prism.enrm3;
     f32 dist_bc = relativePos.ps_dot(enrm3) - prism.height;
     if (m_radius <= dist_bc) {
         return false;
     }
 
-    const EGG::Vector3f &fnrm = m_nrms[prism.fnrm_i];
+    const EGG::Vector3f &fnrm = *prism.fnrm;
     f32 plane_dist = relativePos.ps_dot(fnrm);
     f32 dist_in_plane = m_radius - plane_dist;
     if (dist_in_plane <= 0.0f) {
@@ -547,8 +1030,8 @@ bool KColData::checkSphereMovement(f32 *distOut, EGG::Vector3f *fnrmOut, u16 *at
     }
 
     // Check collision for all triangles, and continuously call the function until we're out
-    while (*++m_prismIter != 0) {
-        const KCollisionPrism &prism = m_prisms[parse<u16>(*m_prismIter)];
+    while (nextCandidate(CollisionCheckType::Movement)) {
+        const PrismRef prism = getPrism(parse<u16>(*m_prismIter));
         if (checkCollision(prism, distOut, fnrmOut, attributeOut, CollisionCheckType::Movement)) {
             return true;
         }
@@ -559,6 +1042,9 @@ bool KColData::checkSphereMovement(f32 *distOut, EGG::Vector3f *fnrmOut, u16 *at
     return false;
 }
 
+bool KColData::s_prismRecords = false;
+size_t KColData::s_blockGridBudget = 0;
+
 KColData::KCollisionPrism::KCollisionPrism() = default;
 
 KColData::KCollisionPrism::KCollisionPrism(f32 height, u16 posIndex, u16 faceNormIndex,
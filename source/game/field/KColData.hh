@@ -34,7 +34,29 @@ public:
     };
     STATIC_ASSERT(sizeof(KCollisionPrism) == 0x10);
 
+    /// @brief A prism which holds its vertex and normals, instead of indices into other arrays.
+    /// @details Kinoko addition. A query then reads one record, rather than gathering from the
+    /// prism, normal and vertex arrays. @see EnablePrismRecords.
+    struct alignas(16) PrismRecord {
+        EGG::Vector3f pos;
+        f32 height;
+        EGG::Vector3f fnrm;
+        u16 attribute;
+        EGG::Vector3f enrm1;
+        EGG::Vector3f enrm2;
+        EGG::Vector3f enrm3;
+    };
+    STATIC_ASSERT(sizeof(PrismRecord) == 0x50);
+
+    /// @brief The sizes of the arrays preloaded from a KCL file.
+    struct ArrayCounts {
+        size_t prisms;
+        size_t nrms;
+        size_t vertices;
+    };
+
     KColData(const void *file);
+    ~KColData();
 
     void narrowScopeLocal(const EGG::Vector3f &pos, f32 radius, KCLTypeMask mask);
     void narrowPolygon_EachBlock(const u16 *prismArray);
@@ -58,12 +80,42 @@ public:
     [[nodiscard]] static EGG::Vector3f GetVertex(f32 height, const EGG::Vector3f &vertex1,
             const EGG::Vector3f &fnrm, const EGG::Vector3f &enrm3, const EGG::Vector3f &enrm);
 
+    static void EnablePrismRecords();
+    static void SetBlockGridBudget(size_t budget);
+
+    [[nodiscard]] static ArrayCounts CountArrays(const void *file);
+    static void Preload(const void *file, std::span<KCollisionPrism> prisms,
+            std::span<EGG::Vector3f> nrms, std::span<EGG::Vector3f> vertices);
+
 private:
-    void preloadPrisms();
-    void preloadNormals();
-    void preloadVertices();
+    /// @brief The fields of a prism, resolved from whichever layout is in use.
+    struct PrismRef {
+        const EGG::Vector3f *pos;
+        const EGG::Vector3f *fnrm;
+        const EGG::Vector3f *enrm1;
+        const EGG::Vector3f *enrm2;
+        const EGG::Vector3f *enrm3;
+        f32 height;
+        u16 attribute;
+    };
+
+    /// @brief The block grid's entry for a root block of the octree. @see buildBlockGrid.
+    struct GridBlock {
+        u32 cells; ///< The leaf's offset if the depth is 0, otherwise the index of the first cell.
+        u32 depth; ///< The depth of the block's deepest leaf below it.
+    };
 
-    [[nodiscard]] bool checkCollision(const KCollisionPrism &prism, f32 *distOut,
+    static void PreloadPrisms(const void *prismData, std::span<KCollisionPrism> prisms);
+    static void PreloadNormals(const void *nrmData, std::span<EGG::Vector3f> nrms);
+    static void PreloadVertices(const void *posData, std::span<EGG::Vector3f> vertices);
+
+    void buildPrismRecords();
+    void buildBlockGrid();
+    void buildBlockTypeMasks();
+    [[nodiscard]] const u16 *searchBlockOfType(const EGG::Vector3f &pos, KCLTypeMask typeMask);
+    [[nodiscard]] PrismRef getPrism(u16 idx) const;
+    [[nodiscard]] bool nextCandidate(CollisionCheckType type);
+    [[nodiscard]] bool checkCollision(const PrismRef &prism, f32 *distOut,
             EGG::Vector3f *fnrmOut, u16 *flagsOut, CollisionCheckType type);
     [[nodiscard]] bool checkSphereMovement(f32 *distOut, EGG::Vector3f *fnrmOut, u16 *attributeOut);
 
@@ -92,12 +144,24 @@ private:
     u16 *m_cachedPrismArray;
     EGG::Vector3f m_cachedPos;
     f32 m_cachedRadius;
+    u32 *m_prismCacheStamps;    ///< For each prism, the generation in which it was last cached.
+    u32 m_prismCacheGeneration; ///< Incremented whenever the prism cache is refilled.
 
     /// @brief Optimizes for time by avoiding unnecessary byteswapping.
     /// The Wii doesn't have this problem because big endian is always assumed.
     std::span<KCollisionPrism> m_prisms;
     std::span<EGG::Vector3f> m_nrms;
     std::span<EGG::Vector3f> m_vertices;
+    std::span<PrismRecord> m_prismRecords; ///< Empty unless prism records are enabled.
+    GridBlock *m_gridBlocks; ///< nullptr unless the block grid is built.
+    u32 *m_gridCells;        ///< The offsets of the leaves, for every cell of every grid block.
+    KCLTypeMask *m_blockTypeMasks;    ///< The types of the prisms in each prism list.
+    u32 m_blockListsOffset;           ///< The offset of the first prism list in the octree.
+    u32 m_blockListsCount;            ///< The number of prism indices the prism lists span.
+    KCLTypeMask m_prismCacheTypeMask; ///< The types of the prisms in the prism cache.
+
+    static bool s_prismRecords;
+    static size_t s_blockGridBudget; ///< The block grid's maximum size, or 0 to disable it.
 };
 
 } // namespace Field
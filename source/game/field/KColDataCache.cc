@@ -0,0 +1,578 @@
+#include "KColDataCache.hh"
+
+#include <abstract/File.hh>
+#include <abstract/SharedMemory.hh>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace Field {
+
+/// @brief Bumped whenever the layout of the segments or the key changes, so that old segments and
+/// cached files are ignored.
+static constexpr u32 SEGMENT_VERSION = 2;
+
+static void GetSegmentName(u64 key, char *buffer, size_t size) {
+    snprintf(buffer, size, "/kinoko-kcl-v%u-%016llx", SEGMENT_VERSION,
+            static_cast<unsigned long long>(key));
+}
+
+/// @brief Starts caching the arrays of each KColData constructed from now on.
+void KColDataCache::Enable() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_enabled = true;
+}
+
+/// @brief Shares the arrays of each KCL file preloaded from now on with other processes, and maps
+/// the arrays other processes shared instead of preloading them.
+/// @details This must be called before any KColData is constructed.
+void KColDataCache::EnableShared() {
+    RemoveStaleSegments();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_shared = true;
+}
+
+/// @brief Removes the segments published with an older layout, which are never mapped again.
+/// @details Processes which still map them keep their mapping.
+void KColDataCache::RemoveStaleSegments() {
+    for (u32 version = 0; version < SEGMENT_VERSION; ++version) {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "/kinoko-kcl-v%u-", version);
+        Abstract::SharedMemory::RemoveAll(prefix);
+    }
+}
+
+/// @brief Stores the arrays of each KCL file preloaded from now on in the given directory, and maps
+/// the arrays stored there instead of preloading them.
+/// @details This must be called before any KColData is constructed. The directory is created if it
+/// does not exist.
+void KColDataCache::SetDirectory(const char *dir) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        PANIC("Failed to create KCL cache directory %s!", dir);
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    snprintf(s_directory, sizeof(s_directory), "%s", dir);
+}
+
+/// @brief Frees every cached entry, and unmaps every shared segment. Any KColData restored from the
+/// cache must be destroyed first.
+void KColDataCache::Clear() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto &entry : s_entries) {
+        std::free(entry.storage);
+        entry = Entry{};
+    }
+
+    for (auto &segment : s_segments) {
+        if (segment.onDisk) {
+            Abstract::File::Unmap(segment.data, segment.size);
+        } else if (segment.data) {
+            Abstract::SharedMemory::Unmap(segment.data, segment.size);
+        }
+        segment = Segment{};
+    }
+}
+
+/// @brief Points the arrays at the cached copies for the given KCL file, if there are any.
+/// @details If sharing is enabled, the arrays may also be restored from a shared segment. If a
+/// directory is set, they may also be mapped from the file stored there.
+/// @return Whether the arrays were restored from the cache.
+bool KColDataCache::Restore(const void *file, std::span<KColData::KCollisionPrism> &prisms,
+        std::span<EGG::Vector3f> &nrms, std::span<EGG::Vector3f> &vertices,
+        EGG::BoundBox3f &bbox) {
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        const Entry *entry = s_enabled ? Find(file) : nullptr;
+        if (entry && !entry->prefetched) {
+            prisms = entry->prisms;
+            nrms = entry->nrms;
+            vertices = entry->vertices;
+            bbox = entry->bbox;
+            return true;
+        }
+
+        if (!s_shared && s_directory[0] == '\0') {
+            return false;
+        }
+    }
+
+    // Hash without holding the lock, so that other threads can restore or prefetch in parallel
+    u64 key = ContentKey(file);
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    const Segment *segment = LookUpSegment(key);
+    if (!segment) {
+        return false;
+    }
+
+    prisms = segment->prisms;
+    nrms = segment->nrms;
+    vertices = segment->vertices;
+    bbox = segment->bbox;
+
+    // The file's prefetched arrays won't be taken, so they are freed. Like in TakePrefetched, the
+    // caller must have joined the thread which prefetched the file.
+    Entry *entry = Find(file);
+    if (entry && entry->prefetched) {
+        std::free(entry->storage);
+        *entry = Entry{};
+        entry = nullptr;
+    }
+
+    // Remember the segment by the file's address too, so that restoring it again skips the hash
+    if (s_enabled && !entry) {
+        entry = Claim(file);
+        if (entry) {
+            entry->prisms = segment->prisms;
+            entry->nrms = segment->nrms;
+            entry->vertices = segment->vertices;
+            entry->bbox = segment->bbox;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Copies the preloaded arrays of a KCL file into the cache, if the cache is enabled.
+/// @details If sharing is enabled, the arrays are also published in a shared segment, unless
+/// another process already published them. The cache then points at the segment rather than
+/// holding a copy of its own. If a directory is set, the arrays are also written to a file there.
+void KColDataCache::Store(const void *file, std::span<KColData::KCollisionPrism> prisms,
+        std::span<EGG::Vector3f> nrms, std::span<EGG::Vector3f> vertices,
+        const EGG::BoundBox3f &bbox) {
+    bool keyed = s_shared || s_directory[0] != '\0';
+
+    // Hash without holding the lock, so that other threads can restore or prefetch in parallel
+    u64 key = keyed ? ContentKey(file) : 0;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    const Segment *segment = keyed ? FindSegment(key) : nullptr;
+    if (!segment && s_shared) {
+        segment = PublishSegment(key, prisms, nrms, vertices, bbox);
+    }
+
+    // Segments mapped from the directory are already stored there
+    if (s_directory[0] != '\0' && (!segment || !segment->onDisk)) {
+        WriteCachedFile(key, prisms, nrms, vertices, bbox);
+    }
+
+    if (!s_enabled || Find(file)) {
+        return;
+    }
+
+    if (segment) {
+        Entry *entry = Claim(file);
+        if (!entry) {
+            WARN("Cannot cache KCL arrays, as the KCL cache is full!");
+            return;
+        }
+
+        entry->prisms = segment->prisms;
+        entry->nrms = segment->nrms;
+        entry->vertices = segment->vertices;
+        entry->bbox = segment->bbox;
+        return;
+    }
+
+    Entry *entry = Allocate(file, prisms.size(), nrms.size(), vertices.size());
+    if (!entry) {
+        WARN("Cannot cache KCL arrays, as the KCL cache is full!");
+        return;
+    }
+
+    memcpy(entry->prisms.data(), prisms.data(), prisms.size_bytes());
+    memcpy(entry->nrms.data(), nrms.data(), nrms.size_bytes());
+    memcpy(entry->vertices.data(), vertices.data(), vertices.size_bytes());
+    entry->bbox = bbox;
+}
+
+/// @brief Preloads the arrays of a KCL file ahead of the construction of its KColData.
+/// @details This doesn't allocate from the engine heaps, so it is safe to call from any thread.
+/// Files whose arrays are already cached, prefetched, shared by another process, or stored in the
+/// directory are skipped.
+void KColDataCache::Prefetch(const void *file) {
+    if (!file) {
+        return;
+    }
+
+    bool keyed;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        if (Find(file)) {
+            return;
+        }
+
+        keyed = s_shared || s_directory[0] != '\0';
+    }
+
+    // Hash without holding the lock, so that other threads can restore or prefetch in parallel
+    u64 key = keyed ? ContentKey(file) : 0;
+
+    KColData::ArrayCounts counts = KColData::CountArrays(file);
+    Entry *entry;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        if (Find(file)) {
+            return;
+        }
+
+        // Restore maps the segment instead, so the preloaded arrays would only be freed
+        if (keyed && LookUpSegment(key)) {
+            return;
+        }
+
+        entry = Allocate(file, counts.prisms, counts.nrms, counts.vertices);
+        if (!entry) {
+            WARN("Cannot prefetch KCL arrays, as the KCL cache is full!");
+            return;
+        }
+
+        // Claim the entry, so that it is not taken before it is filled
+        entry->prefetched = true;
+    }
+
+    // Preload without holding the lock, so that other threads can restore or prefetch in parallel.
+    // Other threads skip the entry, as it is prefetched and its file is only taken after joining.
+    KColData::Preload(file, entry->prisms, entry->nrms, entry->vertices);
+}
+
+/// @brief Copies the prefetched arrays of a KCL file into the given arrays, and frees them.
+/// @details The caller must have joined the thread which prefetched the file.
+/// @return Whether the file was prefetched.
+bool KColDataCache::TakePrefetched(const void *file, std::span<KColData::KCollisionPrism> prisms,
+        std::span<EGG::Vector3f> nrms, std::span<EGG::Vector3f> vertices) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    Entry *entry = Find(file);
+    if (!entry || !entry->prefetched) {
+        return false;
+    }
+
+    ASSERT(entry->prisms.size() == prisms.size());
+    ASSERT(entry->nrms.size() == nrms.size());
+    ASSERT(entry->vertices.size() == vertices.size());
+
+    memcpy(prisms.data(), entry->prisms.data(), prisms.size_bytes());
+    memcpy(nrms.data(), entry->nrms.data(), nrms.size_bytes());
+    memcpy(vertices.data(), entry->vertices.data(), vertices.size_bytes());
+
+    std::free(entry->storage);
+    *entry = Entry{};
+    return true;
+}
+
+/// @brief Claims a free entry, and allocates storage for its arrays.
+/// @details The caller must hold the lock.
+/// @return The entry, or nullptr if the cache is full.
+KColDataCache::Entry *KColDataCache::Allocate(const void *file, size_t prismCount,
+        size_t nrmCount, size_t vertexCount) {
+    Entry *entry = Claim(file);
+    if (!entry) {
+        return nullptr;
+    }
+
+    size_t prismSize = prismCount * sizeof(KColData::KCollisionPrism);
+    size_t nrmSize = nrmCount * sizeof(EGG::Vector3f);
+    size_t vertexSize = vertexCount * sizeof(EGG::Vector3f);
+
+    u8 *storage = reinterpret_cast<u8 *>(std::malloc(prismSize + nrmSize + vertexSize));
+    auto *prisms = reinterpret_cast<KColData::KCollisionPrism *>(storage);
+    auto *nrms = reinterpret_cast<EGG::Vector3f *>(storage + prismSize);
+    auto *vertices = reinterpret_cast<EGG::Vector3f *>(storage + prismSize + nrmSize);
+
+    entry->storage = storage;
+    entry->prisms = std::span<KColData::KCollisionPrism>(prisms, prismCount);
+    entry->nrms = std::span<EGG::Vector3f>(nrms, nrmCount);
+    entry->vertices = std::span<EGG::Vector3f>(vertices, vertexCount);
+    return entry;
+}
+
+/// @brief Claims a free entry, without any storage.
+/// @details The caller must hold the lock.
+/// @return The entry, or nullptr if the cache is full.
+KColDataCache::Entry *KColDataCache::Claim(const void *file) {
+    for (auto &entry : s_entries) {
+        if (entry.file) {
+            continue;
+        }
+
+        entry = Entry{};
+        entry.file = file;
+        return &entry;
+    }
+
+    return nullptr;
+}
+
+/// @details The caller must hold the lock.
+KColDataCache::Entry *KColDataCache::Find(const void *file) {
+    for (auto &entry : s_entries) {
+        if (entry.file == file) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+/// @brief Hashes the parts of a KCL file which the arrays are preloaded from.
+/// @details The prisms end where the blocks begin, so everything before the blocks is hashed.
+u64 KColDataCache::ContentKey(const void *file) {
+    const auto *header = reinterpret_cast<const KColHeader *>(file);
+    return HashLanes64(reinterpret_cast<const u8 *>(file), parse<u32>(header->block_data_offset));
+}
+
+/// @brief Computes the size of the image of a KCL file's arrays, as stored in a segment or a file.
+size_t KColDataCache::ImageSize(size_t prismCount, size_t nrmCount, size_t vertexCount) {
+    return SEGMENT_ARRAYS_OFFSET + prismCount * sizeof(KColData::KCollisionPrism) +
+            (nrmCount + vertexCount) * sizeof(EGG::Vector3f);
+}
+
+/// @brief Writes the image of a KCL file's arrays, except for its ready flag.
+/// @param data The zero-initialized image, sized with ImageSize.
+void KColDataCache::WriteImage(u8 *data, u64 key,
+        std::span<const KColData::KCollisionPrism> prisms, std::span<const EGG::Vector3f> nrms,
+        std::span<const EGG::Vector3f> vertices, const EGG::BoundBox3f &bbox) {
+    auto *header = reinterpret_cast<SegmentHeader *>(data);
+    header->magic = SEGMENT_MAGIC;
+    header->key = key;
+    header->prismCount = prisms.size();
+    header->nrmCount = nrms.size();
+    header->vertexCount = vertices.size();
+    header->bboxMin = bbox.min;
+    header->bboxMax = bbox.max;
+
+    u8 *arrays = data + SEGMENT_ARRAYS_OFFSET;
+    memcpy(arrays, prisms.data(), prisms.size_bytes());
+    arrays += prisms.size_bytes();
+    memcpy(arrays, nrms.data(), nrms.size_bytes());
+    arrays += nrms.size_bytes();
+    memcpy(arrays, vertices.data(), vertices.size_bytes());
+}
+
+/// @brief Finds the segment of a KCL file, mapping the one shared by another process or the file
+/// stored in the directory if needed.
+/// @details The caller must hold the lock.
+/// @return The segment, or nullptr if there is none.
+const KColDataCache::Segment *KColDataCache::LookUpSegment(u64 key) {
+    const Segment *segment = FindSegment(key);
+    if (!segment && s_shared) {
+        segment = OpenSegment(key);
+    }
+    if (!segment && s_directory[0] != '\0') {
+        segment = MapCachedFile(key);
+    }
+
+    return segment;
+}
+
+/// @details The caller must hold the lock.
+const KColDataCache::Segment *KColDataCache::FindSegment(u64 key) {
+    for (const auto &segment : s_segments) {
+        if (segment.data && segment.key == key) {
+            return &segment;
+        }
+    }
+
+    return nullptr;
+}
+
+/// @brief Maps the segment published for a KCL file by another process.
+/// @details The caller must hold the lock. Segments which are still being written are treated as
+/// missing, rather than waited on.
+/// @return The segment, or nullptr if it is missing, incomplete, or invalid.
+const KColDataCache::Segment *KColDataCache::OpenSegment(u64 key) {
+    char name[64];
+    GetSegmentName(key, name, sizeof(name));
+
+    size_t size;
+    const u8 *data = Abstract::SharedMemory::Open(name, size);
+    if (!data) {
+        return nullptr;
+    }
+
+    const auto *header = reinterpret_cast<const SegmentHeader *>(data);
+    auto &ready = const_cast<u32 &>(header->ready);
+    if (size < SEGMENT_ARRAYS_OFFSET ||
+            !std::atomic_ref<u32>(ready).load(std::memory_order_acquire)) {
+        Abstract::SharedMemory::Unmap(data, size);
+        return nullptr;
+    }
+
+    Segment *segment = nullptr;
+    if (header->magic == SEGMENT_MAGIC && header->key == key) {
+        segment = AddSegment(key, data, size, false);
+    }
+
+    if (!segment) {
+        Abstract::SharedMemory::Unmap(data, size);
+    }
+
+    return segment;
+}
+
+/// @brief Publishes the arrays of a KCL file in a new segment, so that other processes can map it.
+/// @details The caller must hold the lock. If another process already published a complete
+/// segment, that segment is mapped instead. An incomplete segment is removed and published again.
+/// @return The segment, or nullptr if it cannot be created.
+const KColDataCache::Segment *KColDataCache::PublishSegment(u64 key,
+        std::span<const KColData::KCollisionPrism> prisms, std::span<const EGG::Vector3f> nrms,
+        std::span<const EGG::Vector3f> vertices, const EGG::BoundBox3f &bbox) {
+    char name[64];
+    GetSegmentName(key, name, sizeof(name));
+
+    size_t size = ImageSize(prisms.size(), nrms.size(), vertices.size());
+    u8 *data = Abstract::SharedMemory::Create(name, size);
+    if (!data) {
+        // Map the segment if it is complete. Otherwise, its writer may have died before finishing
+        // it, so it is replaced. A writer which is still alive keeps its mapping of the old one.
+        const Segment *segment = OpenSegment(key);
+        if (segment) {
+            return segment;
+        }
+
+        Abstract::SharedMemory::Remove(name);
+        data = Abstract::SharedMemory::Create(name, size);
+        if (!data) {
+            return nullptr;
+        }
+    }
+
+    WriteImage(data, key, prisms, nrms, vertices, bbox);
+
+    // Only signal that the segment is complete once everything else is visible
+    auto *header = reinterpret_cast<SegmentHeader *>(data);
+    std::atomic_ref<u32>(header->ready).store(1, std::memory_order_release);
+
+    const u8 *sealed = Abstract::SharedMemory::Seal(data, size);
+    Segment *segment = AddSegment(key, sealed, size, false);
+    if (!segment) {
+        Abstract::SharedMemory::Unmap(sealed, size);
+    }
+
+    return segment;
+}
+
+/// @brief Maps the file stored for a KCL file in the directory, with a single mapping.
+/// @details The caller must hold the lock. Files which are truncated or otherwise corrupted are
+/// treated as missing, and are replaced once the arrays are preloaded again.
+/// @return The segment, or nullptr if the file is missing or invalid.
+const KColDataCache::Segment *KColDataCache::MapCachedFile(u64 key) {
+    char path[512];
+    GetCachedFilePath(key, path, sizeof(path));
+
+    size_t size;
+    const u8 *data = Abstract::File::Map(path, size);
+    if (!data) {
+        return nullptr;
+    }
+
+    // Files are native-endian, so a file written on another platform fails the magic check
+    const auto *header = reinterpret_cast<const SegmentHeader *>(data);
+    Segment *segment = nullptr;
+    if (size >= SEGMENT_ARRAYS_OFFSET && header->magic == SEGMENT_MAGIC && header->ready &&
+            header->key == key) {
+        segment = AddSegment(key, data, size, true);
+    } else {
+        WARN("Ignoring invalid KCL cache file %s!", path);
+    }
+
+    if (!segment) {
+        Abstract::File::Unmap(data, size);
+    }
+
+    return segment;
+}
+
+/// @brief Writes the arrays of a KCL file to the directory, so that later runs can map them.
+/// @details The caller must hold the lock. The write is atomic, so processes storing the same file
+/// at once never observe a partial file.
+void KColDataCache::WriteCachedFile(u64 key, std::span<const KColData::KCollisionPrism> prisms,
+        std::span<const EGG::Vector3f> nrms, std::span<const EGG::Vector3f> vertices,
+        const EGG::BoundBox3f &bbox) {
+    char path[512];
+    GetCachedFilePath(key, path, sizeof(path));
+
+    size_t size = ImageSize(prisms.size(), nrms.size(), vertices.size());
+    u8 *data = reinterpret_cast<u8 *>(std::calloc(size, 1));
+    WriteImage(data, key, prisms, nrms, vertices, bbox);
+    reinterpret_cast<SegmentHeader *>(data)->ready = 1;
+
+    if (!Abstract::File::WriteAtomic(path, data, size)) {
+        WARN("Failed to write %s to the KCL cache!", path);
+    }
+
+    std::free(data);
+}
+
+/// @details The caller must hold the lock.
+void KColDataCache::GetCachedFilePath(u64 key, char *buffer, size_t size) {
+    snprintf(buffer, size, "%s/%016llx-v%u.kcl", s_directory,
+            static_cast<unsigned long long>(key), SEGMENT_VERSION);
+}
+
+/// @brief Records a mapped segment, pointing its arrays into the mapping.
+/// @details The caller must hold the lock, and must have checked the segment's header.
+/// @param onDisk Whether the segment is mapped from the directory rather than shared memory.
+/// @return The segment, or nullptr if the segment is too small for its arrays or the table is
+/// full.
+KColDataCache::Segment *KColDataCache::AddSegment(u64 key, const u8 *data, size_t size,
+        bool onDisk) {
+    const auto *header = reinterpret_cast<const SegmentHeader *>(data);
+    size_t prismSize = header->prismCount * sizeof(KColData::KCollisionPrism);
+    size_t nrmSize = header->nrmCount * sizeof(EGG::Vector3f);
+    size_t vertexSize = header->vertexCount * sizeof(EGG::Vector3f);
+    if (size < SEGMENT_ARRAYS_OFFSET + prismSize + nrmSize + vertexSize) {
+        WARN("Ignoring truncated KCL segment!");
+        return nullptr;
+    }
+
+    for (auto &segment : s_segments) {
+        if (segment.data) {
+            continue;
+        }
+
+        // KColData never writes to its arrays, so they can point into the read-only mapping
+        u8 *arrays = const_cast<u8 *>(data) + SEGMENT_ARRAYS_OFFSET;
+        auto *prisms = reinterpret_cast<KColData::KCollisionPrism *>(arrays);
+        auto *nrms = reinterpret_cast<EGG::Vector3f *>(arrays + prismSize);
+        auto *vertices = reinterpret_cast<EGG::Vector3f *>(arrays + prismSize + nrmSize);
+
+        segment.key = key;
+        segment.data = data;
+        segment.size = size;
+        segment.onDisk = onDisk;
+        segment.prisms = std::span<KColData::KCollisionPrism>(prisms, header->prismCount);
+        segment.nrms = std::span<EGG::Vector3f>(nrms, header->nrmCount);
+        segment.vertices = std::span<EGG::Vector3f>(vertices, header->vertexCount);
+        segment.bbox.min = header->bboxMin;
+        segment.bbox.max = header->bboxMax;
+        return &segment;
+    }
+
+    WARN("Cannot map KCL segment, as the KCL cache is full!");
+    return nullptr;
+}
+
+std::array<KColDataCache::Entry, KColDataCache::MAX_ENTRIES> KColDataCache::s_entries = {};
+std::array<KColDataCache::Segment, KColDataCache::MAX_SEGMENTS> KColDataCache::s_segments = {};
+std::mutex KColDataCache::s_mutex;
+bool KColDataCache::s_enabled = false;
+bool KColDataCache::s_shared = false;
+char KColDataCache::s_directory[256] = {};
+
+} // namespace Field
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "game/field/KColData.hh"
+
+#include <mutex>
+
+namespace Field {
+
+/// @brief Process-wide store of the arrays KColData preloads from a KCL file.
+/// @details Preloading byteswaps every prism, normal, and vertex of the course's KCL, and computes
+/// its bounding box. This is only a function of the file, so hosts which run many races on the
+/// same course can enable the cache to preload each KCL once. The arrays are allocated outside of
+/// the engine heaps, so they survive scene teardown. Entries are keyed by the address of the KCL
+/// file, which is only stable while the archive containing it stays loaded. Hosts enabling the
+/// cache must therefore keep the archive in the System::ArchiveCache, and clear this cache before
+/// evicting the archive.
+///
+/// Independently of whether the cache is enabled, a KCL file's arrays can be prefetched on a worker
+/// thread. The next KColData constructed from the file takes the prefetched arrays instead of
+/// preloading them itself, so the entry only lives for the duration of a scene load.
+///
+/// The arrays can also be shared between processes. Once sharing is enabled, the first process to
+/// preload a KCL file publishes its arrays in a named shared memory segment, keyed by the hash of
+/// the file's contents. Every other process maps the segment read-only instead of preloading the
+/// arrays, so concurrent workers hold a single copy of them. Segments outlive the processes which
+/// create them, until the system restarts. Segments left incomplete by a process which died while
+/// publishing them are replaced, and segments with an older layout are removed once sharing is
+/// enabled.
+///
+/// The arrays can also be stored on disk, in the same native-endian layout as the segments. Once a
+/// directory is set, later runs map the stored arrays with a single mapping instead of preloading
+/// them, which only costs hashing the KCL file.
+class KColDataCache {
+public:
+    static void Enable();
+    static void EnableShared();
+    static void SetDirectory(const char *dir);
+    static void Clear();
+
+    [[nodiscard]] static bool Restore(const void *file,
+            std::span<KColData::KCollisionPrism> &prisms, std::span<EGG::Vector3f> &nrms,
+            std::span<EGG::Vector3f> &vertices, EGG::BoundBox3f &bbox);
+    static void Store(const void *file, std::span<KColData::KCollisionPrism> prisms,
+            std::span<EGG::Vector3f> nrms, std::span<EGG::Vector3f> vertices,
+            const EGG::BoundBox3f &bbox);
+
+    static void Prefetch(const void *file);
+    [[nodiscard]] static bool TakePrefetched(const void *file,
+            std::span<KColData::KCollisionPrism> prisms, std::span<EGG::Vector3f> nrms,
+            std::span<EGG::Vector3f> vertices);
+
+private:
+    struct Entry {
+        const void *file;
+        void *storage;
+        std::span<KColData::KCollisionPrism> prisms;
+        std::span<EGG::Vector3f> nrms;
+        std::span<EGG::Vector3f> vertices;
+        EGG::BoundBox3f bbox;
+        bool prefetched; ///< Whether the entry is waiting to be taken, and has no bounding box.
+    };
+
+    /// @brief An image of the arrays of a KCL file, mapped read-only from either a shared memory
+    /// segment or a file in the directory.
+    struct Segment {
+        u64 key; ///< The hash of the KCL file, see ContentKey.
+        const u8 *data;
+        size_t size;
+        bool onDisk; ///< Whether the image is mapped from a file rather than shared memory.
+        std::span<KColData::KCollisionPrism> prisms;
+        std::span<EGG::Vector3f> nrms;
+        std::span<EGG::Vector3f> vertices;
+        EGG::BoundBox3f bbox;
+    };
+
+    /// @brief The header of an image, which is followed by the arrays.
+    struct SegmentHeader {
+        u32 magic;
+        u32 ready; ///< Set once the image is written, as other processes may open it before.
+        u64 key;
+        u32 prismCount;
+        u32 nrmCount;
+        u32 vertexCount;
+        EGG::Vector3f bboxMin;
+        EGG::Vector3f bboxMax;
+    };
+
+    [[nodiscard]] static Entry *Allocate(const void *file, size_t prismCount, size_t nrmCount,
+            size_t vertexCount);
+
+    [[nodiscard]] static Entry *Claim(const void *file);
+    [[nodiscard]] static Entry *Find(const void *file);
+
+    static void RemoveStaleSegments();
+    [[nodiscard]] static u64 ContentKey(const void *file);
+    [[nodiscard]] static size_t ImageSize(size_t prismCount, size_t nrmCount, size_t vertexCount);
+    static void WriteImage(u8 *data, u64 key, std::span<const KColData::KCollisionPrism> prisms,
+            std::span<const EGG::Vector3f> nrms, std::span<const EGG::Vector3f> vertices,
+            const EGG::BoundBox3f &bbox);
+    [[nodiscard]] static const Segment *LookUpSegment(u64 key);
+    [[nodiscard]] static const Segment *FindSegment(u64 key);
+    [[nodiscard]] static const Segment *OpenSegment(u64 key);
+    [[nodiscard]] static const Segment *PublishSegment(u64 key,
+            std::span<const KColData::KCollisionPrism> prisms, std::span<const EGG::Vector3f> nrms,
+            std::span<const EGG::Vector3f> vertices, const EGG::BoundBox3f &bbox);
+    [[nodiscard]] static const Segment *MapCachedFile(u64 key);
+    static void WriteCachedFile(u64 key, std::span<const KColData::KCollisionPrism> prisms,
+            std::span<const EGG::Vector3f> nrms, std::span<const EGG::Vector3f> vertices,
+            const EGG::BoundBox3f &bbox);
+    static void GetCachedFilePath(u64 key, char *buffer, size_t size);
+    [[nodiscard]] static Segment *AddSegment(u64 key, const u8 *data, size_t size, bool onDisk);
+
+    static constexpr size_t MAX_ENTRIES = 16;
+    static constexpr size_t MAX_SEGMENTS = 16;
+    static constexpr u32 SEGMENT_MAGIC = 0x4B434C53; // KCLS
+
+    /// @brief Arrays start on a cache line, after the header.
+    static constexpr size_t SEGMENT_ARRAYS_OFFSET = 0x40;
+    STATIC_ASSERT(sizeof(SegmentHeader) <= SEGMENT_ARRAYS_OFFSET);
+
+    static std::array<Entry, MAX_ENTRIES> s_entries;
+    static std::array<Segment, MAX_SEGMENTS> s_segments;
+    static std::mutex s_mutex;
+    static bool s_enabled;
+    static bool s_shared;
+    static char s_directory[256]; ///< Empty unless the arrays are stored on disk.
+};
+
+} // namespace Field
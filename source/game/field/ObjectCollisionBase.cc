@@ -1,5 +1,6 @@
 #include "ObjectCollisionBase.hh"
 
+#include <egg/core/EngineContext.hh>
 #include <egg/math/Math.hh>
 
 #include <cmath>
@@ -227,6 +228,7 @@ void ObjectCollisionBase::getNearestPoint(const GJKState &state, u32 idx, EGG::V
 
 /// @addr{0x80835A8C}
 void ObjectCollisionBase::calcSimplex(GJKState &state) const {
+    auto &dotProductCache = Kinoko::EngineContext::Current()->dotProductCache;
     const u32 idx = state.m_idx;
 
     for (u32 i = 0, mask = 1; i < 4; ++i, mask *= 2) {
@@ -235,12 +237,12 @@ void ObjectCollisionBase::calcSimplex(GJKState &state) const {
         }
 
         f32 result = state.m_s[i].dot(state.m_s[idx]);
-        s_dotProductCache[idx][i] = result;
-        s_dotProductCache[i][idx] = result;
+        dotProductCache[idx][i] = result;
+        dotProductCache[i][idx] = result;
     }
 
     state.m_scales[state.m_mask][idx] = 1.0f;
-    s_dotProductCache[idx][idx] = state.m_s[idx].dot();
+    dotProductCache[idx][idx] = state.m_s[idx].dot();
 
     for (u32 i = 0, iMask = 1; i < 4; ++i, iMask *= 2) {
         if ((state.m_flags & iMask) == 0) {
@@ -249,8 +251,8 @@ void ObjectCollisionBase::calcSimplex(GJKState &state) const {
 
         u32 iStateMask = iMask | state.m_mask;
 
-        state.m_scales[iStateMask][i] = s_dotProductCache[idx][idx] - s_dotProductCache[idx][i];
-        state.m_scales[iStateMask][idx] = s_dotProductCache[i][i] - s_dotProductCache[i][idx];
+        state.m_scales[iStateMask][i] = dotProductCache[idx][idx] - dotProductCache[idx][i];
+        state.m_scales[iStateMask][idx] = dotProductCache[i][i] - dotProductCache[i][idx];
 
         for (u32 j = 0, jMask = 1; j < i; ++j, jMask *= 2) {
             if ((state.m_flags & jMask) == 0) {
@@ -258,17 +260,17 @@ void ObjectCollisionBase::calcSimplex(GJKState &state) const {
             }
 
             state.m_scales[jMask | iStateMask][j] = state.m_scales[iStateMask][i] *
-                            (s_dotProductCache[i][i] - s_dotProductCache[i][j]) +
+                            (dotProductCache[i][i] - dotProductCache[i][j]) +
                     state.m_scales[iStateMask][idx] *
-                            (s_dotProductCache[idx][i] - s_dotProductCache[idx][j]);
+                            (dotProductCache[idx][i] - dotProductCache[idx][j]);
             state.m_scales[jMask | iStateMask][i] = state.m_scales[jMask | state.m_mask][j] *
-                            (s_dotProductCache[j][j] - s_dotProductCache[i][j]) +
+                            (dotProductCache[j][j] - dotProductCache[i][j]) +
                     state.m_scales[jMask | state.m_mask][idx] *
-                            (s_dotProductCache[idx][j] - s_dotProductCache[idx][i]);
+                            (dotProductCache[idx][j] - dotProductCache[idx][i]);
             state.m_scales[jMask | iStateMask][idx] = state.m_scales[jMask | iMask][j] *
-                            (s_dotProductCache[j][j] - s_dotProductCache[j][idx]) +
+                            (dotProductCache[j][j] - dotProductCache[j][idx]) +
                     state.m_scales[jMask | iMask][i] *
-                            (s_dotProductCache[i][j] - s_dotProductCache[i][idx]);
+                            (dotProductCache[i][j] - dotProductCache[i][idx]);
         }
     }
 
@@ -276,18 +278,18 @@ void ObjectCollisionBase::calcSimplex(GJKState &state) const {
         return;
     }
 
-    f32 _1_1 = s_dotProductCache[0][0] - s_dotProductCache[0][1];
-    f32 _2_2 = s_dotProductCache[0][0] - s_dotProductCache[0][2];
-    f32 _3_2 = s_dotProductCache[0][0] - s_dotProductCache[0][3];
-    f32 _0_2 = s_dotProductCache[1][1] - s_dotProductCache[1][0];
-    f32 _0_3 = s_dotProductCache[2][1] - s_dotProductCache[2][0];
-    f32 _1_2 = s_dotProductCache[3][0] - s_dotProductCache[3][1];
-    f32 _1_3 = s_dotProductCache[2][0] - s_dotProductCache[2][1];
-    f32 _2_1 = s_dotProductCache[3][0] - s_dotProductCache[3][2];
-    f32 _0_1 = s_dotProductCache[3][1] - s_dotProductCache[3][0];
-    f32 _2_3 = s_dotProductCache[1][0] - s_dotProductCache[1][2];
-    f32 _3_1 = s_dotProductCache[2][0] - s_dotProductCache[2][3];
-    f32 _3_3 = s_dotProductCache[1][0] - s_dotProductCache[1][3];
+    f32 _1_1 = dotProductCache[0][0] - dotProductCache[0][1];
+    f32 _2_2 = dotProductCache[0][0] - dotProductCache[0][2];
+    f32 _3_2 = dotProductCache[0][0] - dotProductCache[0][3];
+    f32 _0_2 = dotProductCache[1][1] - dotProductCache[1][0];
+    f32 _0_3 = dotProductCache[2][1] - dotProductCache[2][0];
+    f32 _1_2 = dotProductCache[3][0] - dotProductCache[3][1];
+    f32 _1_3 = dotProductCache[2][0] - dotProductCache[2][1];
+    f32 _2_1 = dotProductCache[3][0] - dotProductCache[3][2];
+    f32 _0_1 = dotProductCache[3][1] - dotProductCache[3][0];
+    f32 _2_3 = dotProductCache[1][0] - dotProductCache[1][2];
+    f32 _3_1 = dotProductCache[2][0] - dotProductCache[2][3];
+    f32 _3_3 = dotProductCache[1][0] - dotProductCache[1][3];
 
     state.m_scales[15][0] = _0_1 * state.m_scales[14][3] +
             (_0_2 * state.m_scales[14][1] + _0_3 * state.m_scales[14][2]);
@@ -299,6 +301,4 @@ void ObjectCollisionBase::calcSimplex(GJKState &state) const {
             (_3_2 * state.m_scales[7][0] + _3_3 * state.m_scales[7][1]);
 }
 
-std::array<std::array<f32, 4>, 4> ObjectCollisionBase::s_dotProductCache = {{}};
-
 } // namespace Field
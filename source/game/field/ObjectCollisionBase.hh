@@ -47,8 +47,6 @@ private:
     void calcSimplex(GJKState &state) const;
 
     EGG::Vector3f m_00;
-
-    static std::array<std::array<f32, 4>, 4> s_dotProductCache;
 };
 
 } // namespace Field
@@ -8,6 +8,8 @@
 
 #include "game/system/CourseMap.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace Field {
 
 /// @addr{0x8082A2B4}
@@ -120,28 +122,30 @@ const EGG::Vector3f &ObjectDirector::hitDepth(size_t idx) const {
 
 /// @addr{0x8082A784}
 ObjectDirector *ObjectDirector::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new ObjectDirector;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->objectDirector);
+    context->objectDirector = new ObjectDirector;
 
     ObjectDrivableDirector::CreateInstance();
 
-    s_instance->createObjects();
+    context->objectDirector->createObjects();
 
-    return s_instance;
+    return context->objectDirector;
 }
 
 /// @addr{0x8082A824}
 void ObjectDirector::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->objectDirector);
+    auto *instance = context->objectDirector;
+    context->objectDirector = nullptr;
     delete instance;
 
     ObjectDrivableDirector::DestroyInstance();
 }
 
 ObjectDirector *ObjectDirector::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->objectDirector;
 }
 
 /// @addr{0x8082A38C}
@@ -151,8 +155,9 @@ ObjectDirector::ObjectDirector()
 
 /// @addr{0x8082A694}
 ObjectDirector::~ObjectDirector() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->objectDirector) {
+        context->objectDirector = nullptr;
         WARN("ObjectDirector instance not explicitly handled!");
     }
 
@@ -217,6 +222,4 @@ ObjectBase *ObjectDirector::createObject(const System::MapdataGeoObj &params) {
     }
 }
 
-ObjectDirector *ObjectDirector::s_instance = nullptr; ///< @addr{0x809C4330}
-
 } // namespace Field
@@ -48,8 +48,6 @@ private:
             m_collidingObjects; ///< Objects we are currently colliding with
     std::array<EGG::Vector3f, MAX_UNIT_COUNT> m_hitDepths;
     std::array<Kart::Reaction, MAX_UNIT_COUNT> m_reactions;
-
-    static ObjectDirector *s_instance;
 };
 
 } // namespace Field
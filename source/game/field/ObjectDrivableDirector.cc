@@ -1,5 +1,7 @@
 #include "game/field/ObjectDrivableDirector.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace Field {
 
 /// @addr{0x8081B500}
@@ -139,21 +141,23 @@ void ObjectDrivableDirector::colNarScLocal(f32 scale, f32 radius, const EGG::Vec
 
 /// @addr{0x8081B428}
 ObjectDrivableDirector *ObjectDrivableDirector::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new ObjectDrivableDirector;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->objectDrivableDirector);
+    context->objectDrivableDirector = new ObjectDrivableDirector;
+    return context->objectDrivableDirector;
 }
 
 /// @addr{0x8081B4B0}
 void ObjectDrivableDirector::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->objectDrivableDirector);
+    auto *instance = context->objectDrivableDirector;
+    context->objectDrivableDirector = nullptr;
     delete instance;
 }
 
 ObjectDrivableDirector *ObjectDrivableDirector::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->objectDrivableDirector;
 }
 
 /// @addr{0x8082A38C}
@@ -161,12 +165,11 @@ ObjectDrivableDirector::ObjectDrivableDirector() {}
 
 /// @addr{0x8082A694}
 ObjectDrivableDirector::~ObjectDrivableDirector() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->objectDrivableDirector) {
+        context->objectDrivableDirector = nullptr;
         WARN("ObjectDrivableDirector instance not explicitly handled!");
     }
 }
 
-ObjectDrivableDirector *ObjectDrivableDirector::s_instance = nullptr; ///< @addr{0x809C4310}
-
 } // namespace Field
@@ -44,8 +44,6 @@ private:
 
     std::vector<ObjectDrivable *> m_objects; ///< All objects live here
     std::vector<ObjectBase *> m_calcObjects; ///< Objects needing calc() live here too.
-
-    static ObjectDrivableDirector *s_instance;
 };
 
 } // namespace Field
@@ -5,7 +5,7 @@
 namespace Field {
 
 /// @addr{0x8082C10C}
-ObjectFlowTable::ObjectFlowTable(const char *filename) {
+ObjectFlowTable::ObjectFlowTable(const EGG::Archive::Path &filename) {
     SFile *file = reinterpret_cast<SFile *>(System::ResourceManager::Instance()->getFile(filename,
             nullptr, System::ArchiveId::Core));
 
@@ -2,6 +2,8 @@
 
 #include "game/field/obj/ObjectId.hh"
 
+#include <egg/core/Archive.hh>
+
 namespace Field {
 
 /// @brief Maps to SObjectCollisionSet::mode. Determines what type of collision an object has.
@@ -43,7 +45,7 @@ STATIC_ASSERT(sizeof(SObjectCollisionSet) == 0x74);
 
 class ObjectFlowTable {
 public:
-    ObjectFlowTable(const char *filename);
+    ObjectFlowTable(const EGG::Archive::Path &filename);
     ~ObjectFlowTable();
 
     const SObjectCollisionSet *set(s16 slot) const;
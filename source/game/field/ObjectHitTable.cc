@@ -7,7 +7,7 @@
 namespace Field {
 
 /// @addr{0x807F9278}
-ObjectHitTable::ObjectHitTable(const char *filename) {
+ObjectHitTable::ObjectHitTable(const EGG::Archive::Path &filename) {
     size_t size;
     void *file =
             System::ResourceManager::Instance()->getFile(filename, &size, System::ArchiveId::Core);
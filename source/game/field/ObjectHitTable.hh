@@ -4,13 +4,15 @@
 
 #include "game/kart/KartCollide.hh"
 
+#include <egg/core/Archive.hh>
+
 #include <span>
 
 namespace Field {
 
 class ObjectHitTable {
 public:
-    ObjectHitTable(const char *filename);
+    ObjectHitTable(const EGG::Archive::Path &filename);
     ~ObjectHitTable();
 
     Kart::Reaction reaction(s16 i) const;
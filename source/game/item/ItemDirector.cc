@@ -2,6 +2,8 @@
 
 #include "game/system/RaceConfig.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace Item {
 
 /// @addr{0x80799794}
@@ -20,21 +22,23 @@ void ItemDirector::calc() {
 
 /// @addr{0x80799138}
 ItemDirector *ItemDirector::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new ItemDirector;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->itemDirector);
+    context->itemDirector = new ItemDirector;
+    return context->itemDirector;
 }
 
 /// @addr{0x80799188}
 void ItemDirector::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->itemDirector);
+    auto *instance = context->itemDirector;
+    context->itemDirector = nullptr;
     delete instance;
 }
 
 ItemDirector *ItemDirector::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->itemDirector;
 }
 
 /// @addr{0x807992D8}
@@ -49,14 +53,13 @@ ItemDirector::ItemDirector() {
 
 /// @addr{0x80798F9C}
 ItemDirector::~ItemDirector() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->itemDirector) {
+        context->itemDirector = nullptr;
         WARN("ItemDirector instance not explicitly handled!");
     }
 
     delete[] m_karts.data();
 }
 
-ItemDirector *ItemDirector::s_instance = nullptr; ///< @addr{0x809C3618}
-
 } // namespace Item
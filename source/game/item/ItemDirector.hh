@@ -22,8 +22,6 @@ private:
     ~ItemDirector() override;
 
     std::span<KartItem> m_karts;
-
-    static ItemDirector *s_instance; ///< @addr{0x809C3618}
 };
 
 } // namespace Item
@@ -144,7 +144,7 @@ void KartObject::createSub() {
 
 /// @addr{0x8058F820}
 void KartObject::createModel() {
-    s_proxyList.clear();
+    proxyList().clear();
 
     if (isBike()) {
         m_pointers.model = new Render::KartModelBike;
@@ -160,11 +160,13 @@ void KartObject::createModel() {
 /// @addr{0x8058EEB4}
 void KartObject::calcSub() {
     sub()->calcPass0();
+    sub()->runStageCallback(CalcStage::Pass0);
 }
 
 /// @addr{0x8058EEBC}
 void KartObject::calc() {
     sub()->calcPass1();
+    sub()->runStageCallback(CalcStage::Pass1);
     model()->calc();
 }
 
@@ -174,7 +176,7 @@ const KartAccessor *KartObject::accessor() const {
 
 /// @addr{0x8058F5B4}
 KartObject *KartObject::Create(Character character, Vehicle vehicle, u8 playerIdx) {
-    s_proxyList.clear();
+    proxyList().clear();
 
     KartParam *param = new KartParam(character, vehicle, playerIdx);
 
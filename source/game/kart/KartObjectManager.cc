@@ -4,6 +4,8 @@
 #include "game/kart/KartParamFileManager.hh"
 #include "game/system/RaceConfig.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace Kart {
 
 /// @addr{0x8058FEE0}
@@ -37,21 +39,23 @@ KartObject *KartObjectManager::object(size_t i) const {
 
 /// @addr{0x8058FAA8}
 KartObjectManager *KartObjectManager::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new KartObjectManager;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->kartObjectManager);
+    context->kartObjectManager = new KartObjectManager;
+    return context->kartObjectManager;
 }
 
 /// @addr{0x8058FAF8}
 void KartObjectManager::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->kartObjectManager);
+    auto *instance = context->kartObjectManager;
+    context->kartObjectManager = nullptr;
     delete instance;
 }
 
 KartObjectManager *KartObjectManager::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->kartObjectManager;
 }
 
 /// @addr{0x8058FB2C}
@@ -70,8 +74,9 @@ KartObjectManager::KartObjectManager() {
 
 /// @addr{0x8058FDD4}
 KartObjectManager::~KartObjectManager() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->kartObjectManager) {
+        context->kartObjectManager = nullptr;
         WARN("KartObjectManager instance not explicitly handled!");
     }
 
@@ -89,6 +94,4 @@ KartObjectManager::~KartObjectManager() {
     KartObjectProxy::proxyList().clear();
 }
 
-KartObjectManager *KartObjectManager::s_instance = nullptr; ///< @addr{0x809C18F8}
-
 } // namespace Kart
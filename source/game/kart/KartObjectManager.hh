@@ -26,8 +26,6 @@ private:
 
     size_t m_count;
     KartObject **m_objects;
-
-    static KartObjectManager *s_instance; ///< @addr{0x809C18F8}
 };
 
 } // namespace Kart
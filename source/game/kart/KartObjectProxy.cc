@@ -12,6 +12,7 @@
 #include "game/system/RaceManager.hh"
 #include "game/system/map/MapdataCannonPoint.hh"
 
+#include <egg/core/EngineContext.hh>
 #include <egg/math/Math.hh>
 
 #include <algorithm>
@@ -20,7 +21,7 @@ namespace Kart {
 
 /// @addr{0x8059018C}
 KartObjectProxy::KartObjectProxy() : m_accessor(nullptr) {
-    s_proxyList.push_back(this);
+    proxyList().push_back(this);
 }
 
 KartObjectProxy::~KartObjectProxy() = default;
@@ -205,7 +206,7 @@ const CollisionData &KartObjectProxy::collisionData() const {
 
 /// @addr{0x805903F4}
 const System::KPad *KartObjectProxy::inputs() const {
-    return System::RaceManager::Instance()->player().inputs();
+    return System::RaceManager::Instance()->player(param()->playerIdx()).inputs();
 }
 
 /// @addr{0x80590A40}
@@ -392,8 +393,9 @@ bool KartObjectProxy::isInRespawn() const {
     return move()->respawnTimer() > 0 || move()->respawnPostLandTimer() > 0;
 }
 
-std::list<KartObjectProxy *> &KartObjectProxy::proxyList() {
-    return s_proxyList;
+/// @brief The list of all KartObjectProxy children.
+Kinoko::EngineState::ProxyList &KartObjectProxy::proxyList() {
+    return Kinoko::EngineContext::Current()->proxyList;
 }
 
 /// @addr{0x805901D0}
@@ -405,11 +407,10 @@ void KartObjectProxy::apply(size_t idx) {
 /// @brief For all proxies in the static list, synchronizes all pointers to the KartAccessor.
 /// @param pointers The pointer to synchronize all other proxies to.
 void KartObjectProxy::ApplyAll(const KartAccessor *pointers) {
-    for (auto iter = s_proxyList.begin(); iter != s_proxyList.end(); ++iter) {
+    auto &list = proxyList();
+    for (auto iter = list.begin(); iter != list.end(); ++iter) {
         (*iter)->m_accessor = pointers;
     }
 }
 
-std::list<KartObjectProxy *> KartObjectProxy::s_proxyList; ///< @addr{0x809C1900}
-
 } // namespace Kart
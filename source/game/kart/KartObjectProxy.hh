@@ -2,9 +2,9 @@
 
 #include "game/system/KPadController.hh"
 
+#include <egg/core/EngineContext.hh>
 #include <egg/math/Matrix.hh>
 
-#include <list>
 #include <vector>
 
 namespace Field {
@@ -146,7 +146,7 @@ public:
     [[nodiscard]] f32 speedRatioCapped() const;
     [[nodiscard]] bool isInRespawn() const;
 
-    [[nodiscard]] static std::list<KartObjectProxy *> &proxyList();
+    [[nodiscard]] static Kinoko::EngineState::ProxyList &proxyList();
     /// @endGetters
 
 protected:
@@ -156,8 +156,6 @@ private:
     static void ApplyAll(const KartAccessor *pointers);
 
     const KartAccessor *m_accessor;
-
-    static std::list<KartObjectProxy *> s_proxyList; ///< List of all KartObjectProxy children.
 };
 
 } // namespace Kart
@@ -2,6 +2,8 @@
 
 #include "game/system/ResourceManager.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace Kart {
 
 /// @addr{0x80591C9C}
@@ -112,20 +114,22 @@ EGG::RamStream KartParamFileManager::getBikeDispParamsStream(Vehicle vehicle) co
 }
 
 KartParamFileManager *KartParamFileManager::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new KartParamFileManager;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->kartParamFileManager);
+    context->kartParamFileManager = new KartParamFileManager;
+    return context->kartParamFileManager;
 }
 
 void KartParamFileManager::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->kartParamFileManager);
+    auto *instance = context->kartParamFileManager;
+    context->kartParamFileManager = nullptr;
     delete instance;
 }
 
 KartParamFileManager *KartParamFileManager::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->kartParamFileManager;
 }
 
 KartParamFileManager::KartParamFileManager() {
@@ -133,8 +137,9 @@ KartParamFileManager::KartParamFileManager() {
 }
 
 KartParamFileManager::~KartParamFileManager() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->kartParamFileManager) {
+        context->kartParamFileManager = nullptr;
         WARN("KartParamFileManager instance not explicitly handled!");
     }
 }
@@ -179,11 +184,9 @@ void KartParamFileManager::FileInfo::clear() {
     size = 0;
 }
 
-void KartParamFileManager::FileInfo::load(const char *filename) {
+void KartParamFileManager::FileInfo::load(const EGG::Archive::Path &filename) {
     auto *resourceManager = System::ResourceManager::Instance();
     file = resourceManager->getFile(filename, &size, System::ArchiveId::Core);
 }
 
-KartParamFileManager *KartParamFileManager::s_instance = nullptr;
-
 } // namespace Kart
@@ -2,6 +2,8 @@
 
 #include "game/kart/KartParam.hh"
 
+#include <egg/core/Archive.hh>
+
 namespace Kart {
 
 /// @brief Abstraction for the process of retrieving kart parameters from files.
@@ -29,7 +31,7 @@ private:
 
     struct FileInfo {
         void clear();
-        void load(const char *filename);
+        void load(const EGG::Archive::Path &filename);
 
         void *file;
         size_t size;
@@ -43,8 +45,6 @@ private:
     FileInfo m_kartParam;     // kartParam.bin
     FileInfo m_driverParam;   // driverParam.bin
     FileInfo m_bikeDispParam; // bikePartsDispParam.bin
-
-    static KartParamFileManager *s_instance;
 };
 
 } // namespace Kart
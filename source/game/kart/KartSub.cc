@@ -178,6 +178,7 @@ void KartSub::calcPass1() {
 
     collide()->calcObjectCollision();
     dynamics()->setPos(pos() + collide()->tangentOff());
+    runStageCallback(CalcStage::ObjectCollision);
 
     if (state()->isSomethingWallCollision()) {
         const EGG::Vector3f &softWallSpeed = state()->softWallSpeed();
@@ -243,6 +244,8 @@ void KartSub::calcPass1() {
         }
     }
 
+    runStageCallback(CalcStage::CourseCollision);
+
     EGG::Vector3f forward = fullRot().rotateVector(EGG::Vector3f::ez);
     m_someScale = scale().y;
 
@@ -263,6 +266,8 @@ void KartSub::calcPass1() {
         }
     }
 
+    runStageCallback(CalcStage::WheelCollision);
+
     if (!state()->isSkipWheelCalc()) {
         EGG::Vector3f vehicleCompensation = m_maxSuspOvertravel + m_minSuspOvertravel;
         dynamics()->setPos(dynamics()->pos() + vehicleCompensation);
@@ -316,6 +321,23 @@ void KartSub::calcPass1() {
     // calcRotation() is only ever used for gfx rendering, so skip
 }
 
+/// @brief Runs the stage callback registered by the host, if there is one.
+void KartSub::runStageCallback(CalcStage stage) const {
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->kartStageCallback) {
+        context->kartStageCallback(stage, param()->playerIdx(), context->kartStageCallbackArg);
+    }
+}
+
+/// @brief Registers a callback to run at each CalcStage of every kart's frame.
+/// @param callback The callback, or nullptr to stop running one.
+/// @param arg The argument sent into the callback.
+void KartSub::RegisterStageCallback(const StageCallback &callback, void *arg) {
+    auto *context = Kinoko::EngineContext::Current();
+    context->kartStageCallback = callback;
+    context->kartStageCallbackArg = arg;
+}
+
 /// @addr{0x80598338}
 void KartSub::resizeAABB(f32 radiusScale) {
     f32 radius = radiusScale * collisionGroup()->boundingRadius();
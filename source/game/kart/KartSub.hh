@@ -2,14 +2,29 @@
 
 #include "game/kart/KartMove.hh"
 
+#include <functional>
+
 namespace Kart {
 
 class KartObject;
 
+/// @brief Points in a kart's frame at which the host's stage callback runs.
+/// @details These are not part of the base game. They let hosts inspect the kart between the
+/// passes of a frame, for example to find the pass in which a desync starts.
+enum class CalcStage : u8 {
+    Pass0,           ///< After KartSub::calcPass0.
+    ObjectCollision, ///< After colliding with objects, in KartSub::calcPass1.
+    CourseCollision, ///< After colliding with the course, in KartSub::calcPass1.
+    WheelCollision,  ///< After the suspensions collide, in KartSub::calcPass1.
+    Pass1,           ///< After KartSub::calcPass1.
+};
+
 /// @brief Hosts a few classes and the high level per-frame calc functions.
 /// @nosubgrouping
 class KartSub : KartObjectProxy {
 public:
+    typedef std::function<void(CalcStage stage, u8 playerIdx, void *arg)> StageCallback;
+
     KartSub();
     ~KartSub();
 
@@ -27,6 +42,9 @@ public:
     void addFloor(const CollisionData &, bool);
     void updateSuspOvertravel(const EGG::Vector3f &suspOvertravel);
     void tryEndHWG();
+    void runStageCallback(CalcStage stage) const;
+
+    static void RegisterStageCallback(const StageCallback &callback, void *arg);
 
     /// @beginGetters
     [[nodiscard]] f32 someScale();
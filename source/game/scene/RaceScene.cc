@@ -2,6 +2,8 @@
 
 #include "game/field/BoxColManager.hh"
 #include "game/field/CollisionDirector.hh"
+#include "game/field/CourseColMgr.hh"
+#include "game/field/KColDataCache.hh"
 #include "game/field/ObjectDirector.hh"
 #include "game/item/ItemDirector.hh"
 #include "game/kart/KartObjectManager.hh"
@@ -11,8 +13,18 @@
 #include "game/system/RaceManager.hh"
 #include "game/system/ResourceManager.hh"
 
+#include <abstract/Thread.hh>
+
 namespace Scene {
 
+static void DecompressArchive(void *archive) {
+    reinterpret_cast<System::MultiDvdArchive *>(archive)->decompressDeferred();
+}
+
+static void PrefetchKCL(void *file) {
+    Field::KColDataCache::Prefetch(file);
+}
+
 /// @addr{0x80553B88}
 RaceScene::RaceScene() {
     m_heap->setName("RaceSceneHeap");
@@ -22,8 +34,8 @@ RaceScene::RaceScene() {
 RaceScene::~RaceScene() = default;
 
 /// @addr{0x80554208}
+/// @details In Kinoko, the CourseMap is created at the end of RaceScene::configure instead.
 void RaceScene::createEngines() {
-    System::CourseMap::CreateInstance()->init();
     System::RaceManager::CreateInstance();
     Field::BoxColManager::CreateInstance();
     Kart::KartObjectManager::CreateInstance();
@@ -67,17 +79,34 @@ void RaceScene::destroyEngines() {
 
 /// @brief Retrieves Common.szs and the course archive.
 /// @addr{0x80553C50}
+/// @details Kinoko loads the archives as a pipeline. The course archive is decompressed on a
+/// worker thread while Common.szs is decompressed on this one. Once both are mounted, the KCL is
+/// preloaded on a worker thread while the CourseMap parses the KMP, which the base game does at
+/// the start of RaceScene::createEngines. The workers never allocate from the heaps, which are
+/// only ever touched by this thread.
 void RaceScene::configure() {
     auto *raceCfg = System::RaceConfig::Instance();
     auto *resMgr = System::ResourceManager::Instance();
 
     raceCfg->initRace();
 
-    auto *commonArc = resMgr->load(0, nullptr);
+    auto *commonArc = resMgr->load(0, nullptr, true);
+    auto *courseArc = resMgr->load(raceCfg->raceScenario().course, true);
+
+    Abstract::Thread worker;
+    worker.start(DecompressArchive, courseArc);
+    commonArc->decompressDeferred();
+    worker.join();
+
+    commonArc->mountDeferred();
     appendResource(commonArc, 0);
 
-    auto *courseArc = resMgr->load(raceCfg->raceScenario().course);
+    courseArc->mountDeferred();
     appendResource(courseArc, 1);
+
+    worker.start(PrefetchKCL, Field::CourseColMgr::LoadFile("course.kcl"));
+    System::CourseMap::CreateInstance()->init();
+    worker.join();
 }
 
 /// @brief This is called on race shutdown in order to prep for the next race.
@@ -0,0 +1,159 @@
+#include "ArchiveCache.hh"
+
+#include "game/system/ArchiveDiskCache.hh"
+
+#include <abstract/File.hh>
+
+#include <egg/core/Decomp.hh>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace System {
+
+/// @brief Strips the leading slash, so that both spellings of a path map to the same entry.
+static const char *NormalizePath(const char *path) {
+    return path[0] == '/' ? path + 1 : path;
+}
+
+/// @brief Frees an image, whether it was decompressed into memory or mapped from disk.
+static void FreeImage(void *image, size_t size, bool mapped) {
+    if (mapped) {
+        ArchiveDiskCache::Unmap(image, size);
+    } else {
+        std::free(image);
+    }
+}
+
+/// @brief Rips and decompresses an archive into the cache, if it is not cached already.
+/// @param path The path to the compressed archive, including its extension.
+/// @return Whether the archive is cached.
+bool ArchiveCache::Load(const char *path) {
+    path = NormalizePath(path);
+
+    if (IsCached(path)) {
+        return true;
+    }
+
+    // Decompress without holding the lock, so that other threads can load in parallel
+    Abstract::File::MappedFile file(path);
+    s32 expandSize = file.size() < 0x10 ? -1 : EGG::Decomp::GetExpandSize(file.data());
+    if (expandSize < 0) {
+        WARN("Cannot cache %s, as it is not a compressed archive!", path);
+        return false;
+    }
+
+    size_t imageSize = expandSize;
+    void *image = nullptr;
+    bool mapped = false;
+
+    if (ArchiveDiskCache::IsEnabled()) {
+        image = ArchiveDiskCache::Map(file.data(), file.size(), imageSize);
+        mapped = image != nullptr;
+    }
+
+    if (!image) {
+        image = std::malloc(expandSize);
+        EGG::Decomp::DecodeSZS(file.data(), reinterpret_cast<u8 *>(image));
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    // Another thread may have cached the same archive in the meantime
+    if (Find(path)) {
+        FreeImage(image, imageSize, mapped);
+        return true;
+    }
+
+    for (auto &entry : s_entries) {
+        if (entry.image) {
+            continue;
+        }
+
+        snprintf(entry.path, sizeof(entry.path), "%s", path);
+        entry.image = image;
+        entry.size = imageSize;
+        entry.refCount = 0;
+        entry.mapped = mapped;
+        return true;
+    }
+
+    WARN("Cannot cache %s, as the archive cache is full!", path);
+    FreeImage(image, imageSize, mapped);
+    return false;
+}
+
+/// @brief Frees a cached archive.
+/// @param path The path the archive was cached with.
+/// @return Whether the archive was evicted. Archives which are still mounted cannot be evicted.
+bool ArchiveCache::Evict(const char *path) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    Entry *entry = Find(NormalizePath(path));
+    if (!entry) {
+        return false;
+    }
+
+    if (entry->refCount > 0) {
+        WARN("Cannot evict %s, as it is still mounted!", entry->path);
+        return false;
+    }
+
+    FreeImage(entry->image, entry->size, entry->mapped);
+    *entry = Entry{};
+    return true;
+}
+
+/// @brief Retrieves a cached archive for mounting.
+/// @details Each successful call must be paired with a call to Release.
+/// @param path The path to the compressed archive, including its extension.
+/// @param size Receives the size of the decompressed archive.
+/// @return The decompressed archive, or nullptr if it is not cached.
+void *ArchiveCache::Acquire(const char *path, size_t &size) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    Entry *entry = Find(NormalizePath(path));
+    if (!entry) {
+        return nullptr;
+    }
+
+    ++entry->refCount;
+    size = entry->size;
+    return entry->image;
+}
+
+/// @brief Signals that an archive retrieved through Acquire is no longer mounted.
+void ArchiveCache::Release(const void *image) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto &entry : s_entries) {
+        if (entry.image == image) {
+            ASSERT(entry.refCount > 0);
+            --entry.refCount;
+            return;
+        }
+    }
+
+    PANIC("Released an archive which is not cached!");
+}
+
+bool ArchiveCache::IsCached(const char *path) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return Find(NormalizePath(path));
+}
+
+/// @details The caller must hold the lock.
+ArchiveCache::Entry *ArchiveCache::Find(const char *path) {
+    for (auto &entry : s_entries) {
+        if (entry.image && strcmp(entry.path, path) == 0) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+std::array<ArchiveCache::Entry, ArchiveCache::MAX_ENTRIES> ArchiveCache::s_entries = {};
+std::mutex ArchiveCache::s_mutex;
+
+} // namespace System
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Common.hh>
+
+#include <mutex>
+
+namespace System {
+
+/// @brief Process-wide store of decompressed archives that outlive the scenes which mount them.
+/// @details In the base game, every scene rips and decompresses its archives from the disc when it
+/// loads. Hosts which run many races in a row can instead load an archive into the cache once, and
+/// DvdArchive will mount the cached image directly rather than decompressing it again. Images are
+/// allocated outside of the engine heaps, so they survive scene teardown, can be shared between
+/// engine contexts, and are inherited copy-on-write by forked processes. Images are read-only once
+/// cached. If the ArchiveDiskCache is enabled, images are mapped from it instead of decompressed.
+class ArchiveCache {
+public:
+    static bool Load(const char *path);
+    static bool Evict(const char *path);
+
+    [[nodiscard]] static void *Acquire(const char *path, size_t &size);
+    static void Release(const void *image);
+
+    [[nodiscard]] static bool IsCached(const char *path);
+
+private:
+    struct Entry {
+        char path[256];
+        void *image;
+        size_t size;
+        u32 refCount;
+        bool mapped; ///< Whether the image is mapped from the ArchiveDiskCache.
+    };
+
+    [[nodiscard]] static Entry *Find(const char *path);
+
+    static constexpr size_t MAX_ENTRIES = 64;
+
+    static std::array<Entry, MAX_ENTRIES> s_entries;
+    static std::mutex s_mutex;
+};
+
+} // namespace System
@@ -0,0 +1,105 @@
+#include "ArchiveDiskCache.hh"
+
+#include <abstract/Archive.hh>
+#include <abstract/File.hh>
+
+#include <egg/core/Decomp.hh>
+
+#include <cstdlib>
+#include <filesystem>
+
+namespace System {
+
+/// @brief Enables the cache, creating the directory if it does not exist.
+/// @param dir The directory to store images in.
+void ArchiveDiskCache::SetDirectory(const char *dir) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        PANIC("Failed to create archive cache directory %s!", dir);
+    }
+
+    snprintf(s_directory, sizeof(s_directory), "%s", dir);
+}
+
+bool ArchiveDiskCache::IsEnabled() {
+    return s_directory[0] != '\0';
+}
+
+/// @brief Maps the decompressed image of a compressed archive, decompressing it on a miss.
+/// @details On a miss, the image is written to the cache before being mapped, so that it is shared
+/// with later runs. The write is atomic, so processes decompressing the same archive at once
+/// never observe a partial image.
+/// @param file The compressed archive.
+/// @param fileSize The size of the compressed archive.
+/// @param size Receives the size of the decompressed archive.
+/// @return The read-only image, or nullptr if the data is not compressed or the cache cannot be
+/// used. Must be released with Unmap.
+void *ArchiveDiskCache::Map(const u8 *file, size_t fileSize, size_t &size) {
+    ASSERT(IsEnabled());
+
+    s32 expandSize = EGG::Decomp::GetExpandSize(file);
+    if (expandSize <= 0) {
+        return nullptr;
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%016llx.u8", s_directory,
+            static_cast<unsigned long long>(HashFnv1a64(file, fileSize)));
+
+    const u8 *image = MapImage(path, expandSize);
+    if (!image) {
+        u8 *buffer = reinterpret_cast<u8 *>(std::malloc(expandSize));
+        EGG::Decomp::DecodeSZS(file, buffer);
+
+        bool written = Abstract::File::WriteAtomic(path, buffer, expandSize);
+        std::free(buffer);
+
+        if (!written) {
+            WARN("Failed to write %s to the archive cache!", path);
+            return nullptr;
+        }
+
+        image = MapImage(path, expandSize);
+        if (!image) {
+            return nullptr;
+        }
+    }
+
+    size = expandSize;
+
+    // Mounting never writes to the image, so it is safe to mount it through a non-const pointer
+    return const_cast<u8 *>(image);
+}
+
+/// @brief Releases an image returned by Map.
+void ArchiveDiskCache::Unmap(void *image, size_t size) {
+    Abstract::File::Unmap(reinterpret_cast<const u8 *>(image), size);
+}
+
+/// @brief Maps a cached image, if it exists and is valid.
+/// @details Images which are truncated or otherwise corrupted are treated as missing, and are
+/// replaced once decompressed again.
+/// @param path The path of the image.
+/// @param expandSize The size of the image, as stored in the compressed archive.
+/// @return The image, or nullptr if it is missing or invalid.
+const u8 *ArchiveDiskCache::MapImage(const char *path, s32 expandSize) {
+    size_t size;
+    const u8 *image = Abstract::File::Map(path, size);
+    if (!image) {
+        return nullptr;
+    }
+
+    if (size != static_cast<size_t>(expandSize) || size < sizeof(u32) ||
+            form<u32>(image) != U8_SIGNATURE) {
+        WARN("Ignoring invalid archive cache image %s!", path);
+        Abstract::File::Unmap(image, size);
+        return nullptr;
+    }
+
+    return image;
+}
+
+char ArchiveDiskCache::s_directory[256] = {};
+
+} // namespace System
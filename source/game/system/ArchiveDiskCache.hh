@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Common.hh>
+
+namespace System {
+
+/// @brief Opt-in directory of decompressed archive images, shared between runs and processes.
+/// @details Each image is stored under the hash of the compressed archive it was decompressed
+/// from, so an archive which changes on disk is never mounted from a stale image. Images are
+/// mapped read-only rather than loaded, so mounting a cached archive costs a hash of the compressed
+/// file instead of a decompression, pages are only read once accessed, and every process which
+/// mounts the same archive shares its pages. The cache is disabled until a directory is set.
+class ArchiveDiskCache {
+public:
+    static void SetDirectory(const char *dir);
+    [[nodiscard]] static bool IsEnabled();
+
+    [[nodiscard]] static void *Map(const u8 *file, size_t fileSize, size_t &size);
+    static void Unmap(void *image, size_t size);
+
+private:
+    [[nodiscard]] static const u8 *MapImage(const char *path, s32 expandSize);
+
+    static char s_directory[256];
+};
+
+} // namespace System
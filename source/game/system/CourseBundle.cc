@@ -0,0 +1,81 @@
+#include "CourseBundle.hh"
+
+#include <abstract/Archive.hh>
+
+namespace System {
+
+/// @brief Maps the bundle and validates its index.
+/// @param path The path to the bundle, relative to the working directory.
+void CourseBundle::Open(const char *path) {
+    Abstract::File::MappedFile file(path);
+
+    auto *header = reinterpret_cast<const Header *>(file.data());
+    if (file.size() < sizeof(Header) || parse<u32>(header->magic) != MAGIC) {
+        PANIC("%s is not a course bundle!", path);
+    }
+
+    if (parse<u16>(header->version) != VERSION) {
+        PANIC("%s has version %d, but version %d is expected! Regenerate the bundle", path,
+                parse<u16>(header->version), VERSION);
+    }
+
+    u16 count = parse<u16>(header->count);
+    if (file.size() < sizeof(Header) + count * sizeof(Entry)) {
+        PANIC("%s is truncated!", path);
+    }
+
+    auto *entries = reinterpret_cast<const Entry *>(header + 1);
+    for (u16 i = 0; i < count; ++i) {
+        size_t offset = static_cast<size_t>(parse<u32>(entries[i].page)) * PAGE_SIZE;
+        size_t size = parse<u32>(entries[i].size);
+        if (size == 0) {
+            continue;
+        }
+
+        auto *archive =
+                reinterpret_cast<const Abstract::ArchiveHandle::RawArchive *>(file.data() + offset);
+        if (offset + size > file.size() || size < sizeof(*archive) ||
+                !archive->isValidSignature()) {
+            PANIC("%s holds an invalid image for course %d!", path, i);
+        }
+    }
+
+    s_file = std::move(file);
+}
+
+bool CourseBundle::IsOpen() {
+    return s_file.data() != nullptr;
+}
+
+/// @brief Finds the decompressed image of a course archive.
+/// @param course The course to find.
+/// @param size Receives the size of the image.
+/// @return The read-only image, or nullptr if the bundle is not open or lacks the course.
+const u8 *CourseBundle::Find(Course course, size_t &size) {
+    if (!IsOpen()) {
+        return nullptr;
+    }
+
+    auto *header = reinterpret_cast<const Header *>(s_file.data());
+    u16 idx = static_cast<u16>(course);
+    if (idx >= parse<u16>(header->count)) {
+        return nullptr;
+    }
+
+    const Entry &entry = reinterpret_cast<const Entry *>(header + 1)[idx];
+    size = parse<u32>(entry.size);
+    if (size == 0) {
+        return nullptr;
+    }
+
+    return s_file.data() + static_cast<size_t>(parse<u32>(entry.page)) * PAGE_SIZE;
+}
+
+bool CourseBundle::Contains(Course course) {
+    size_t size;
+    return Find(course, size) != nullptr;
+}
+
+Abstract::File::MappedFile CourseBundle::s_file;
+
+} // namespace System
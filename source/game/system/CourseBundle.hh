@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Common.hh>
+
+#include <abstract/File.hh>
+
+namespace System {
+
+/// @brief Opt-in file holding the decompressed images of many course archives, indexed by course.
+/// @details Hosts which hop between courses otherwise rip and decompress a course archive on every
+/// switch. The bundle is generated ahead of time by tools/generate_course_bundle.py, and is mapped
+/// read-only once it is opened. Each image is page-aligned, so mounting a bundled course is only a
+/// lookup in the index, pages are only read once accessed, and every process which opens the same
+/// bundle shares its pages. Images are never unmapped until the process exits.
+class CourseBundle {
+public:
+    static void Open(const char *path);
+    [[nodiscard]] static bool IsOpen();
+
+    [[nodiscard]] static const u8 *Find(Course course, size_t &size);
+    [[nodiscard]] static bool Contains(Course course);
+
+private:
+    /// @brief The header of the bundle, which is followed by one entry per course ID.
+    struct Header {
+        u32 magic;
+        u16 version;
+        u16 count;
+    };
+    STATIC_ASSERT(sizeof(Header) == 0x8);
+
+    struct Entry {
+        u32 page; ///< The offset of the image, in pages.
+        u32 size; ///< 0 if the course is not bundled.
+    };
+    STATIC_ASSERT(sizeof(Entry) == 0x8);
+
+    static constexpr u32 MAGIC = 0x4B434244; // KCBD
+    static constexpr u16 VERSION = 1;
+    static constexpr size_t PAGE_SIZE = 0x1000;
+
+    static Abstract::File::MappedFile s_file;
+};
+
+} // namespace System
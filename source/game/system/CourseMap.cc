@@ -11,6 +11,8 @@
 
 #include "game/system/ResourceManager.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace System {
 
 /// @addr{0x805127EC}
@@ -356,21 +358,23 @@ f32 CourseMap::startTmp3() const {
 
 /// @addr{0x80512694}
 CourseMap *CourseMap::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new CourseMap;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->courseMap);
+    context->courseMap = new CourseMap;
+    return context->courseMap;
 }
 
 /// @addr{0x8051271C}
 void CourseMap::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->courseMap);
+    auto *instance = context->courseMap;
+    context->courseMap = nullptr;
     delete instance;
 }
 
 CourseMap *CourseMap::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->courseMap;
 }
 
 /// @addr{0x8051276C}
@@ -380,8 +384,9 @@ CourseMap::CourseMap()
 
 /// @addr{0x805127AC}
 CourseMap::~CourseMap() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->courseMap) {
+        context->courseMap = nullptr;
         WARN("CourseMap instance not explicitly handled!");
     }
 
@@ -635,10 +640,8 @@ void CourseMap::clearSectorChecked() {
 }
 
 /// @addr{0x80512C10}
-void *CourseMap::LoadFile(const char *filename) {
+void *CourseMap::LoadFile(const EGG::Archive::Path &filename) {
     return ResourceManager::Instance()->getFile(filename, nullptr, ArchiveId::Course);
 }
 
-CourseMap *CourseMap::s_instance = nullptr; ///< @addr{0x809BD6E8}
-
 } // namespace System
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <egg/core/Archive.hh>
 #include <egg/math/Vector.hh>
 
 /// @brief High-level handling for generic system operations, such as input reading, race
@@ -105,9 +106,7 @@ private:
     f32 m_startTmp2;
     f32 m_startTmp3;
 
-    static void *LoadFile(const char *filename); ///< @addr{0x809BD6E8}
-
-    static CourseMap *s_instance;
+    static void *LoadFile(const EGG::Archive::Path &filename); ///< @addr{0x809BD6E8}
 };
 
 } // namespace System
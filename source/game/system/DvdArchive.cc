@@ -1,5 +1,9 @@
 #include "DvdArchive.hh"
 
+#include "game/system/ArchiveCache.hh"
+#include "game/system/ArchiveDiskCache.hh"
+#include "game/system/CourseBundle.hh"
+
 #include <abstract/File.hh>
 
 #include <egg/core/Decomp.hh>
@@ -9,7 +13,7 @@ namespace System {
 /// @addr{0x80518CC0}
 DvdArchive::DvdArchive()
     : m_archive(nullptr), m_archiveStart(nullptr), m_archiveSize(0), m_fileStart(nullptr),
-      m_fileSize(0), m_state(State::Cleared) {}
+      m_fileSize(0), m_state(State::Cleared), m_cached(false), m_mapped(false), m_bundled(false) {}
 
 /// @addr{0x80518CF4}
 DvdArchive::~DvdArchive() {
@@ -26,21 +30,14 @@ void DvdArchive::decompress() {
 }
 
 /// @addr{0x80519420}
-void *DvdArchive::getFile(const char *filename, size_t *size) const {
+void *DvdArchive::getFile(const EGG::Archive::Path &filename, size_t *size) const {
     if (m_state != State::Mounted) {
         return nullptr;
     }
 
-    char buffer[256];
-    if (filename[0] == '/') {
-        snprintf(buffer, sizeof(buffer), "%s", filename);
-    } else {
-        snprintf(buffer, sizeof(buffer), "/%s", filename);
-    }
-    buffer[sizeof(buffer) - 1] = '\0';
-
+    // The search starts from the root either way, so the path doesn't need a leading slash
     Abstract::ArchiveHandle::FileInfo fileInfo{0, 0};
-    s32 entryId = m_archive->convertPathToEntryId(buffer);
+    s32 entryId = m_archive->convertPathToEntryId(filename);
     if (entryId == -1) {
         return nullptr;
     }
@@ -55,13 +52,20 @@ void *DvdArchive::getFile(const char *filename, size_t *size) const {
 
 /// @addr{0x80518E10}
 void DvdArchive::load(const char *path, bool decompress_) {
+    if (m_state == State::Cleared && decompress_ && loadCached(path)) {
+        mount();
+        return;
+    }
+
     if (m_state == State::Cleared) {
         rip(path);
     }
 
     if (m_state == State::Ripped) {
         if (decompress_) {
-            decompress();
+            if (!loadMapped()) {
+                decompress();
+            }
             clearFile();
         } else {
             move();
@@ -111,14 +115,125 @@ void DvdArchive::move() {
     m_state = State::Decompressed;
 }
 
+/// @details Kinoko maps the file rather than copying it into the heap.
 /// @addr{0x805190F0}
 void DvdArchive::rip(const char *path) {
-    m_fileStart = Abstract::File::Load(path, m_fileSize);
+    m_view = Abstract::File::MappedFile(path);
+
+    // Decompressing and mounting never write to the file, so the read-only view can be used as is
+    m_fileStart = const_cast<u8 *>(m_view.data());
+    m_fileSize = m_view.size();
     if (m_fileSize != 0 && m_fileStart) {
         m_state = State::Ripped;
     }
 }
 
+/// @brief Kinoko addition to skip ripping and decompressing archives held by the ArchiveCache.
+/// @param path The path to the compressed archive.
+/// @return Whether the archive was found in the cache.
+bool DvdArchive::loadCached(const char *path) {
+    m_archiveStart = ArchiveCache::Acquire(path, m_archiveSize);
+    if (!m_archiveStart) {
+        return false;
+    }
+
+    m_cached = true;
+    m_state = State::Decompressed;
+    return true;
+}
+
+/// @brief Kinoko addition to mount the ripped archive's image from the ArchiveDiskCache.
+/// @details The image is decompressed into the cache on a miss.
+/// @return Whether the disk cache is enabled and the image was mapped.
+bool DvdArchive::loadMapped() {
+    if (!ArchiveDiskCache::IsEnabled()) {
+        return false;
+    }
+
+    m_archiveStart = ArchiveDiskCache::Map(reinterpret_cast<u8 *>(m_fileStart), m_fileSize,
+            m_archiveSize);
+    if (!m_archiveStart) {
+        return false;
+    }
+
+    m_mapped = true;
+    m_state = State::Decompressed;
+    return true;
+}
+
+/// @brief Kinoko addition to mount a course archive's image from the CourseBundle.
+/// @details The image is mounted in place, so nothing is ripped, decompressed, or copied.
+/// @return Whether the bundle is open and holds the course.
+bool DvdArchive::loadBundled(Course course) {
+    if (m_state != State::Cleared) {
+        return false;
+    }
+
+    const u8 *image = CourseBundle::Find(course, m_archiveSize);
+    if (!image) {
+        return false;
+    }
+
+    // Mounting never writes to the image, so the read-only mapping can be used as is
+    m_archiveStart = const_cast<u8 *>(image);
+    m_bundled = true;
+    m_state = State::Decompressed;
+    mount();
+    return true;
+}
+
+/// @brief Kinoko addition to load an archive in stages, so that it can be decompressed on a worker
+/// thread.
+/// @details Archives which are cached or mapped are mounted right away. Otherwise, the archive is
+/// ripped and its image is allocated, and decompressDeferred and mountDeferred finish the load.
+/// @param path The path to the compressed archive.
+void DvdArchive::loadDeferred(const char *path) {
+    if (m_state == State::Cleared && loadCached(path)) {
+        mount();
+        return;
+    }
+
+    if (m_state == State::Cleared) {
+        rip(path);
+    }
+
+    if (m_state != State::Ripped) {
+        return;
+    }
+
+    if (loadMapped()) {
+        clearFile();
+        mount();
+        return;
+    }
+
+    m_archiveSize = EGG::Decomp::GetExpandSize(reinterpret_cast<u8 *>(m_fileStart));
+    m_archiveStart = new u8[m_archiveSize];
+    m_state = State::Decompressing;
+}
+
+/// @brief Decompresses an archive loaded with loadDeferred into its image.
+/// @details The image is already allocated, so this is safe to call from any thread.
+void DvdArchive::decompressDeferred() {
+    if (m_state != State::Decompressing) {
+        return;
+    }
+
+    EGG::Decomp::DecodeSZS(reinterpret_cast<u8 *>(m_fileStart),
+            reinterpret_cast<u8 *>(m_archiveStart));
+    m_state = State::Decompressed;
+}
+
+/// @brief Mounts an archive loaded with loadDeferred, once it is decompressed.
+void DvdArchive::mountDeferred() {
+    if (m_state != State::Decompressed) {
+        return;
+    }
+
+    clearFile();
+    mount();
+}
+
 /// @addr{0x80519240}
 void DvdArchive::clear() {
     clearArchive();
@@ -131,7 +246,20 @@ void DvdArchive::clearArchive() {
         return;
     }
 
-    delete[] static_cast<u8 *>(m_archiveStart);
+    if (m_cached) {
+        ArchiveCache::Release(m_archiveStart);
+        m_cached = false;
+    } else if (m_mapped) {
+        ArchiveDiskCache::Unmap(m_archiveStart, m_archiveSize);
+        m_mapped = false;
+    } else if (m_bundled) {
+        m_bundled = false;
+    } else if (m_archiveStart == m_view.data()) {
+        m_view.reset();
+    } else {
+        delete[] static_cast<u8 *>(m_archiveStart);
+    }
+
     m_archiveStart = nullptr;
     m_archiveSize = 0;
 }
@@ -142,7 +270,12 @@ void DvdArchive::clearFile() {
         return;
     }
 
-    delete[] static_cast<u8 *>(m_fileStart);
+    if (m_fileStart == m_view.data()) {
+        m_view.reset();
+    } else {
+        delete[] static_cast<u8 *>(m_fileStart);
+    }
+
     m_fileStart = nullptr;
     m_fileSize = 0;
 }
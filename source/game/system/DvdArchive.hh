@@ -2,6 +2,8 @@
 
 #include <egg/core/Archive.hh>
 
+#include <abstract/File.hh>
+
 namespace System {
 
 class DvdArchive {
@@ -11,19 +13,26 @@ public:
         Ripped = 1,
         Decompressed = 2,
         Mounted = 3,
+        Decompressing = 4, ///< Kinoko addition, see loadDeferred.
     };
 
     DvdArchive();
     ~DvdArchive();
 
     void decompress();
-    void *getFile(const char *filename, size_t *size) const;
+    void *getFile(const EGG::Archive::Path &filename, size_t *size) const;
     void load(const char *path, bool decompress_);
     void load(const DvdArchive *other);
     void load(void *fileStart, size_t fileSize, bool decompress_);
     void mount();
     void move();
     void rip(const char *path);
+    [[nodiscard]] bool loadCached(const char *path);
+    [[nodiscard]] bool loadMapped();
+    [[nodiscard]] bool loadBundled(Course course);
+    void loadDeferred(const char *path);
+    void decompressDeferred();
+    void mountDeferred();
 
     void clear();
     void clearArchive();
@@ -40,6 +49,12 @@ private:
     void *m_fileStart;
     size_t m_fileSize;
     State m_state;
+    bool m_cached;  ///< Whether the archive is owned by the ArchiveCache.
+    bool m_mapped;  ///< Whether the archive is mapped from the ArchiveDiskCache.
+    bool m_bundled; ///< Whether the archive is owned by the CourseBundle.
+
+    /// @brief The ripped file. Owns the file, or the archive if the file was moved into it.
+    Abstract::File::MappedFile m_view;
 };
 
 } // namespace System
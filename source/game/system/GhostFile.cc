@@ -117,6 +117,21 @@ void RawGhostFile::init(const u8 *rkg) {
     }
 }
 
+/// @brief Kinoko addition. Loads a ghost read from an untrusted file without panicking.
+/// @return Whether the file held a valid ghost. The buffer is left untouched otherwise.
+bool RawGhostFile::tryInit(const u8 *rkg, size_t size) {
+    if (!fits(rkg, size) || !isValid(rkg)) {
+        return false;
+    }
+
+    if (compressed(rkg)) {
+        return decompress(rkg);
+    }
+
+    memcpy(m_buffer, rkg, RKG_UNCOMPRESSED_FILE_SIZE);
+    return true;
+}
+
 /// @addr{0x8051D1B4}
 bool RawGhostFile::decompress(const u8 *rkg) {
     memcpy(m_buffer, rkg, RKG_HEADER_SIZE);
@@ -145,7 +160,7 @@ bool RawGhostFile::decompress(const u8 *rkg) {
 /// @todo Check lap times sum to race time?
 bool RawGhostFile::isValid(const u8 *rkg) const {
     if (strncmp(reinterpret_cast<const char *>(rkg), "RKGD", 4) != 0) {
-        PANIC("RKG header malformed");
+        WARN("RKG header malformed");
         return false;
     }
 
@@ -169,13 +184,16 @@ bool RawGhostFile::isValid(const u8 *rkg) const {
     WeightClass vehicleWeight = VehicleToWeight(vehicle);
 
     if (charWeight == WeightClass::Invalid) {
-        PANIC("Invalid character weight class!");
+        WARN("Invalid character weight class!");
+        return false;
     }
     if (vehicleWeight == WeightClass::Invalid) {
-        PANIC("Invalid vehicle weight class!");
+        WARN("Invalid vehicle weight class!");
+        return false;
     }
     if (charWeight != vehicleWeight) {
-        PANIC("Character/Bike weight class mismatch!");
+        WARN("Character/Bike weight class mismatch!");
+        return false;
     }
 
     return true;
@@ -194,4 +212,32 @@ bool RawGhostFile::compressed(const u8 *rkg) const {
     return ((*(rkg + 0xC) >> 3) & 1) == 1;
 }
 
+/// @brief Kinoko addition. Checks that a file of the given size holds the whole ghost.
+/// @details An uncompressed ghost must contain the full input data section, optionally followed by
+/// its CRC. A compressed ghost must contain the Yaz0 stream its length field claims, and that
+/// stream must expand into the input data section.
+bool RawGhostFile::fits(const u8 *rkg, size_t size) const {
+    if (size < RKG_HEADER_SIZE || size > RKG_MAX_FILE_SIZE) {
+        return false;
+    }
+
+    if (!compressed(rkg)) {
+        return size >= RKG_UNCOMPRESSED_FILE_SIZE;
+    }
+
+    constexpr size_t YAZ0_OFFSET = RKG_HEADER_SIZE + RKG_COMPRESSED_LENGTH_SIZE;
+    if (size < YAZ0_OFFSET + RKG_YAZ0_HEADER_SIZE) {
+        return false;
+    }
+
+    u32 length = parse<u32>(*reinterpret_cast<const u32 *>(rkg + RKG_HEADER_SIZE));
+    if (length < RKG_YAZ0_HEADER_SIZE || length > size - YAZ0_OFFSET) {
+        return false;
+    }
+
+    s32 uncompressedSize = EGG::Decomp::GetExpandSize(rkg + YAZ0_OFFSET);
+    return uncompressedSize > 0 &&
+            static_cast<u32>(uncompressedSize) <= RKG_UNCOMPRESSED_INPUT_DATA_SECTION_SIZE;
+}
+
 } // namespace System
@@ -15,6 +15,10 @@ static constexpr size_t RKG_INPUT_DATA_SIZE =
         RKG_UNCOMPRESSED_INPUT_DATA_SECTION_SIZE - RKG_INPUT_DATA_HEADER_SIZE;
 static constexpr size_t RKG_UNCOMPRESSED_FILE_SIZE =
         RKG_HEADER_SIZE + RKG_UNCOMPRESSED_INPUT_DATA_SECTION_SIZE;
+static constexpr size_t RKG_CRC_SIZE = 0x4;
+static constexpr size_t RKG_MAX_FILE_SIZE = RKG_UNCOMPRESSED_FILE_SIZE + RKG_CRC_SIZE;
+static constexpr size_t RKG_COMPRESSED_LENGTH_SIZE = 0x4;
+static constexpr size_t RKG_YAZ0_HEADER_SIZE = 0x10;
 static constexpr size_t RKG_USER_DATA_OFFSET = 0x20;
 static constexpr size_t RKG_USER_DATA_SIZE = 0x14;
 static constexpr size_t RKG_MII_DATA_OFFSET = 0x3C;
@@ -60,8 +64,11 @@ public:
     RawGhostFile &operator=(const u8 *rkg);
 
     void init(const u8 *rkg);
+    [[nodiscard]] bool tryInit(const u8 *rkg, size_t size);
     [[nodiscard]] bool decompress(const u8 *rkg);
     [[nodiscard]] bool isValid(const u8 *rkg) const;
+    [[nodiscard]] bool compressed(const u8 *rkg) const;
+    [[nodiscard]] bool fits(const u8 *rkg, size_t size) const;
 
     [[nodiscard]] const u8 *buffer() const;
 
@@ -69,8 +76,6 @@ public:
     [[nodiscard]] T parseAt(size_t offset) const;
 
 private:
-    [[nodiscard]] bool compressed(const u8 *rkg) const;
-
     u8 m_buffer[RKG_UNCOMPRESSED_FILE_SIZE];
 };
 STATIC_ASSERT(sizeof(RawGhostFile) == RKG_UNCOMPRESSED_FILE_SIZE);
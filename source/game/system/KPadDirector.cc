@@ -1,16 +1,24 @@
 #include "KPadDirector.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace System {
 
 /// @addr{0x805238F0}
 void KPadDirector::calc() {
     calcPads();
-    m_playerInput.calc();
+
+    for (size_t i = 0; i < playerCount(); ++i) {
+        m_playerInputs[i].calc();
+    }
 }
 
 /// @addr{0x805237E8}
 void KPadDirector::calcPads() {
-    m_ghostController->calc();
+    for (size_t i = 0; i < playerCount(); ++i) {
+        m_ghostControllers[i]->calc();
+    }
+
     m_hostController->calc();
 }
 
@@ -19,21 +27,28 @@ void KPadDirector::clear() {}
 
 /// @addr{0x80523690}
 void KPadDirector::reset() {
-    m_playerInput.reset();
+    for (size_t i = 0; i < playerCount(); ++i) {
+        m_playerInputs[i].reset();
+    }
 }
 
 /// @addr{0x80524580}
 void KPadDirector::startGhostProxies() {
-    m_playerInput.startGhostProxy();
+    for (size_t i = 0; i < playerCount(); ++i) {
+        m_playerInputs[i].startGhostProxy();
+    }
 }
 
 /// @addr{0x805245DC}
 void KPadDirector::endGhostProxies() {
-    m_playerInput.endGhostProxy();
+    for (size_t i = 0; i < playerCount(); ++i) {
+        m_playerInputs[i].endGhostProxy();
+    }
 }
 
-const KPadPlayer &KPadDirector::playerInput() const {
-    return m_playerInput;
+const KPadPlayer &KPadDirector::playerInput(size_t playerIdx) const {
+    ASSERT(playerIdx < m_playerInputs.size());
+    return m_playerInputs[playerIdx];
 }
 
 KPadHostController *KPadDirector::hostController() {
@@ -41,46 +56,58 @@ KPadHostController *KPadDirector::hostController() {
 }
 
 /// @addr{0x8052453C}
-void KPadDirector::setGhostPad(const u8 *inputs, bool driftIsAuto) {
-    m_playerInput.setGhostController(m_ghostController, inputs, driftIsAuto);
+void KPadDirector::setGhostPad(u8 playerIdx, const u8 *inputs, bool driftIsAuto) {
+    ASSERT(playerIdx < m_playerInputs.size());
+    m_playerInputs[playerIdx].setGhostController(m_ghostControllers[playerIdx], inputs,
+            driftIsAuto);
 }
 
+/// @brief Drives the first player with the host controller.
 void KPadDirector::setHostPad(bool driftIsAuto) {
-    m_playerInput.setHostController(m_hostController, driftIsAuto);
+    m_playerInputs[0].setHostController(m_hostController, driftIsAuto);
 }
 
 /// @addr{0x8052313C}
 KPadDirector *KPadDirector::CreateInstance() {
-    ASSERT(!s_instance);
-    return s_instance = new KPadDirector;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->kPadDirector);
+    return context->kPadDirector = new KPadDirector;
 }
 
 /// @addr{0x8052318C}
 void KPadDirector::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->kPadDirector);
+    auto *instance = context->kPadDirector;
+    context->kPadDirector = nullptr;
     delete instance;
 }
 
 KPadDirector *KPadDirector::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->kPadDirector;
 }
 
 /// @addr{0x805232F0}
 KPadDirector::KPadDirector() {
-    m_ghostController = new KPadGhostController;
+    for (auto *&controller : m_ghostControllers) {
+        controller = new KPadGhostController;
+    }
+
     m_hostController = new KPadHostController;
 }
 
 /// @addr{0x805231DC}
 KPadDirector::~KPadDirector() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->kPadDirector) {
+        context->kPadDirector = nullptr;
         WARN("KPadDirector instance not explicitly handled!");
     }
 }
 
-KPadDirector *KPadDirector::s_instance = nullptr; ///< @addr{0x809BD70C}
+/// @brief The number of players of the current race, whose pads must all be set.
+size_t KPadDirector::playerCount() const {
+    return RaceConfig::Instance()->raceScenario().playerCount;
+}
 
 } // namespace System
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "game/system/KPadController.hh"
+#include "game/system/RaceConfig.hh"
 
 namespace System {
 
 /// @brief The highest level abstraction for controller processing.
 /// @addr{0x809BD70C}
+/// @details Each player reads its inputs from its own KPadPlayer. Ghosts each have their own ghost
+/// controller, while the host controller can only drive the first player.
 class KPadDirector : EGG::Disposer {
 public:
     void calc();
@@ -15,10 +18,10 @@ public:
     void startGhostProxies();
     void endGhostProxies();
 
-    [[nodiscard]] const KPadPlayer &playerInput() const;
+    [[nodiscard]] const KPadPlayer &playerInput(size_t playerIdx) const;
     [[nodiscard]] KPadHostController *hostController();
 
-    void setGhostPad(const u8 *inputs, bool driftIsAuto);
+    void setGhostPad(u8 playerIdx, const u8 *inputs, bool driftIsAuto);
     void setHostPad(bool driftIsAuto);
 
     static KPadDirector *CreateInstance();
@@ -29,11 +32,11 @@ private:
     KPadDirector();
     ~KPadDirector() override;
 
-    KPadPlayer m_playerInput;
-    KPadGhostController *m_ghostController;
-    KPadHostController *m_hostController;
+    [[nodiscard]] size_t playerCount() const;
 
-    static KPadDirector *s_instance; ///< @addr{0x809BD70C}
+    std::array<KPadPlayer, MAX_PLAYER_COUNT> m_playerInputs;
+    std::array<KPadGhostController *, MAX_PLAYER_COUNT> m_ghostControllers;
+    KPadHostController *m_hostController;
 };
 
 } // namespace System
@@ -35,7 +35,7 @@ MultiDvdArchive::~MultiDvdArchive() {
 }
 
 /// @addr{0x8052A760}
-void *MultiDvdArchive::getFile(const char *filename, size_t *size) const {
+void *MultiDvdArchive::getFile(const EGG::Archive::Path &filename, size_t *size) const {
     void *file = nullptr;
 
     for (u16 i = m_archiveCount; i-- > 0;) {
@@ -80,6 +80,60 @@ void MultiDvdArchive::load(const char *filename) {
     }
 }
 
+/// @brief Kinoko addition to mount an uncompressed archive, such as a core pack, as the first
+/// archive.
+/// @details The archive is mapped and mounted in place, without being decompressed or copied.
+/// @param path The full path to the archive, including its extension.
+void MultiDvdArchive::loadImage(const char *path) {
+    m_archives[0].load(path, false);
+}
+
+/// @brief Kinoko addition to mount a course's image from the CourseBundle as the first archive.
+/// @return Whether the bundle is open and holds the course.
+bool MultiDvdArchive::loadBundled(Course course) {
+    return m_archives[0].loadBundled(course);
+}
+
+/// @brief Kinoko addition to load the archives in stages, see DvdArchive::loadDeferred.
+void MultiDvdArchive::loadDeferred(const char *filename) {
+    char buffer[256];
+
+    for (u16 i = 0; i < m_archiveCount; i++) {
+        switch (m_formats[i]) {
+        case Format::Double:
+            snprintf(buffer, sizeof(buffer), "%s%s", filename, m_suffixes[i]);
+            break;
+        case Format::Single:
+            snprintf(buffer, sizeof(buffer), "%s", filename);
+            break;
+        case Format::None:
+            break;
+        default:
+            continue;
+        }
+
+        if (m_formats[i] == Format::None) {
+            m_archives[i].load(m_fileStarts[i], m_fileSizes[i], true);
+        } else {
+            m_archives[i].loadDeferred(buffer);
+        }
+    }
+}
+
+/// @brief Decompresses the archives loaded with loadDeferred. This is safe to call from any thread.
+void MultiDvdArchive::decompressDeferred() {
+    for (u16 i = 0; i < m_archiveCount; i++) {
+        m_archives[i].decompressDeferred();
+    }
+}
+
+/// @brief Mounts the archives loaded with loadDeferred, once they are decompressed.
+void MultiDvdArchive::mountDeferred() {
+    for (u16 i = 0; i < m_archiveCount; i++) {
+        m_archives[i].mountDeferred();
+    }
+}
+
 /// @addr{0x8052AAE8}
 void MultiDvdArchive::load(const MultiDvdArchive *other) {
     for (u16 i = 0; i < m_archiveCount; i++) {
@@ -17,8 +17,13 @@ public:
     MultiDvdArchive(u16 archiveCount = 1);
     ~MultiDvdArchive();
 
-    void *getFile(const char *filename, size_t *size) const;
+    void *getFile(const EGG::Archive::Path &filename, size_t *size) const;
     void load(const char *filename);
+    void loadImage(const char *path);
+    [[nodiscard]] bool loadBundled(Course course);
+    void loadDeferred(const char *filename);
+    void decompressDeferred();
+    void mountDeferred();
     void load(const MultiDvdArchive *other);
     void rip(const char *filename);
 
@@ -4,6 +4,8 @@
 
 #include <abstract/File.hh>
 
+#include <egg/core/EngineContext.hh>
+
 namespace System {
 
 /// @addr{0x8052DD40}
@@ -17,8 +19,9 @@ void RaceConfig::init() {
 void RaceConfig::initRace() {
     m_raceScenario.playerCount = 1;
 
-    if (s_onInitCallback) {
-        s_onInitCallback(this, s_onInitCallbackArg);
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->raceConfigInitCallback) {
+        context->raceConfigInitCallback(this, context->raceConfigInitCallbackArg);
     }
 
     initControllers();
@@ -27,57 +30,86 @@ void RaceConfig::initRace() {
 /// @addr{0x8052F4E8}
 /// @brief Initializes the controllers.
 /// @details This is normally scoped within RaceConfig::Scenario, but Kinoko doesn't support menus.
+/// Only the first player can be local, as there is a single host controller.
 void RaceConfig::initControllers() {
-    switch (m_raceScenario.players[0].type) {
-    case Player::Type::Ghost:
-        initGhost();
-        break;
-    case Player::Type::Local:
-        KPadDirector::Instance()->setHostPad(m_raceScenario.players[0].driftIsAuto);
-        break;
-    default:
-        PANIC("Players must be either local or ghost!");
-        break;
+    ASSERT(m_raceScenario.playerCount > 0 && m_raceScenario.playerCount <= MAX_PLAYER_COUNT);
+
+    for (u8 i = 0; i < m_raceScenario.playerCount; ++i) {
+        const Player &player = m_raceScenario.players[i];
+
+        switch (player.type) {
+        case Player::Type::Ghost:
+            initGhost(i);
+            break;
+        case Player::Type::Local:
+            if (i != 0) {
+                PANIC("Only the first player can be local!");
+            }
+
+            KPadDirector::Instance()->setHostPad(player.driftIsAuto);
+            break;
+        default:
+            PANIC("Players must be either local or ghost!");
+            break;
+        }
     }
 }
 
 /// @addr{0x8052EEF0}
-/// @brief Initializes the ghost.
+/// @brief Initializes a player's ghost.
 /// @details This is normally scoped within RaceConfig::Scenario, but Kinoko doesn't support menus.
-void RaceConfig::initGhost() {
-    GhostFile ghost(m_ghost);
+/// The first player's ghost decides the course, which every other ghost must share.
+void RaceConfig::initGhost(u8 playerIdx) {
+    GhostFile ghost(m_ghosts[playerIdx]);
+
+    if (playerIdx == 0) {
+        m_raceScenario.course = ghost.course();
+    } else if (ghost.course() != m_raceScenario.course) {
+        PANIC("Ghost %u is not on the same course as the first ghost!", playerIdx);
+    }
 
-    m_raceScenario.course = ghost.course();
-    Player &player = m_raceScenario.players[0];
+    Player &player = m_raceScenario.players[playerIdx];
     player.character = ghost.character();
     player.vehicle = ghost.vehicle();
     player.driftIsAuto = ghost.driftIsAuto();
 
-    KPadDirector::Instance()->setGhostPad(ghost.inputs(), ghost.driftIsAuto());
+    KPadDirector::Instance()->setGhostPad(playerIdx, ghost.inputs(), ghost.driftIsAuto());
 }
 
+/** @brief Host-agnostic way of initializing RaceConfig.
+    The type of the first player *must* be set to either Local or Ghost. To race more than one
+    player, the player count must be set, and every other player must be a Ghost.
+
+    - If the type is Ghost, the player's ghost must be set with setGhost.
+
+    - If the type is Local, the race scenario's course and the first player's character, vehicle,
+    and driftIsAuto must be set.
+*/
 void RaceConfig::RegisterInitCallback(const InitCallback &callback, void *arg) {
-    s_onInitCallback = callback;
-    s_onInitCallbackArg = arg;
+    auto *context = Kinoko::EngineContext::Current();
+    context->raceConfigInitCallback = callback;
+    context->raceConfigInitCallbackArg = arg;
 }
 
 /// @addr{0x8052FE58}
 RaceConfig *RaceConfig::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new RaceConfig;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->raceConfig);
+    context->raceConfig = new RaceConfig;
+    return context->raceConfig;
 }
 
 /// @addr{0x8052FFE8}
 void RaceConfig::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->raceConfig);
+    auto *instance = context->raceConfig;
+    context->raceConfig = nullptr;
     delete instance;
 }
 
 RaceConfig *RaceConfig::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->raceConfig;
 }
 
 /// @addr{0x8053015C}
@@ -85,8 +117,9 @@ RaceConfig::RaceConfig() = default;
 
 /// @addr{0x80530038}
 RaceConfig::~RaceConfig() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->raceConfig) {
+        context->raceConfig = nullptr;
         WARN("RaceConfig instance not explicitly handled!");
     }
 }
@@ -104,19 +137,4 @@ void RaceConfig::Scenario::init() {
     }
 }
 
-RaceConfig *RaceConfig::s_instance = nullptr; ///< @addr{0x809BD728}
-
-/** @brief Host-agnostic way of initializing RaceConfig.
-    The type of the first player *must* be set to either Local or Ghost.
-
-    - If the type is Ghost, m_ghost must be set to a decompressed ghost file.
-
-    - If the type is Local, the race scenario's course and the first player's character, vehicle,
-    and driftIsAuto must be set.
-*/
-RaceConfig::InitCallback RaceConfig::s_onInitCallback = nullptr;
-
-/// @brief The argument sent into the callback. This is expected to be reinterpret_casted.
-void *RaceConfig::s_onInitCallbackArg = nullptr;
-
 } // namespace System
@@ -6,6 +6,9 @@
 
 namespace System {
 
+/// @brief The number of players a race can hold at most.
+static constexpr size_t MAX_PLAYER_COUNT = 12;
+
 /// @addr{0x809BD728}
 /// @brief Initializes the player with parameters specified in the provided ghost file.
 /// @details In the base game, this class is responsible for managing the race and menu scenarios.
@@ -37,7 +40,7 @@ public:
 
         void init();
 
-        std::array<Player, 12> players;
+        std::array<Player, MAX_PLAYER_COUNT> players;
         u8 playerCount;
         Course course;
     };
@@ -47,7 +50,7 @@ public:
     void init();
     void initRace();
     void initControllers();
-    void initGhost();
+    void initGhost(u8 playerIdx);
 
     [[nodiscard]] const Scenario &raceScenario() const {
         return m_raceScenario;
@@ -57,8 +60,9 @@ public:
         return m_raceScenario;
     }
 
-    void setGhost(const u8 *rkg) {
-        m_ghost = rkg;
+    void setGhost(u8 playerIdx, const u8 *rkg) {
+        ASSERT(playerIdx < m_ghosts.size());
+        m_ghosts[playerIdx] = rkg;
     }
 
     static void RegisterInitCallback(const InitCallback &callback, void *arg);
@@ -72,11 +76,7 @@ private:
     ~RaceConfig() override;
 
     Scenario m_raceScenario;
-    RawGhostFile m_ghost;
-
-    static RaceConfig *s_instance; ///< @addr{0x809BD728}
-    static InitCallback s_onInitCallback;
-    static void *s_onInitCallbackArg;
+    std::array<RawGhostFile, MAX_PLAYER_COUNT> m_ghosts; ///< The ghost of each player, if any.
 };
 
 } // namespace System
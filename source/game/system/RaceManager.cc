@@ -2,20 +2,27 @@
 
 #include "game/system/CourseMap.hh"
 #include "game/system/KPadDirector.hh"
+#include "game/system/RaceConfig.hh"
 #include "game/system/map/MapdataCheckPath.hh"
 #include "game/system/map/MapdataStartPoint.hh"
 
 #include "game/kart/KartObjectManager.hh"
 #include "game/kart/KartState.hh"
 
+#include <egg/core/EngineContext.hh>
+
 namespace System {
 
 /// @addr{0x80532F88}
 void RaceManager::init() {
-    m_player.init();
+    for (auto *player : m_players) {
+        player->init();
+    }
 }
 
 /// @addr{0x805362DC}
+/// @details Time trial ghosts never touch each other, so they all start from the same point, as if
+/// each of them raced alone.
 /// @todo When expanding to other gamemodes, we will need to pass the player index
 void RaceManager::findKartStartPoint(EGG::Vector3f &pos, EGG::Vector3f &angles) {
     u32 placement = 1;
@@ -34,7 +41,13 @@ void RaceManager::findKartStartPoint(EGG::Vector3f &pos, EGG::Vector3f &angles)
 
 /// @addr{0x80533C6C}
 void RaceManager::endPlayerRace(u32 /*idx*/) {
-    // We only have one player, so most of the logic is much simpler
+    // Every player is a ghost, so most of the logic is much simpler
+    for (const auto *player : m_players) {
+        if (!player->isFinished()) {
+            return;
+        }
+    }
+
     m_stage = Stage::FinishGlobal;
 }
 
@@ -43,7 +56,10 @@ void RaceManager::calc() {
     constexpr u16 STAGE_INTRO_DURATION = 172;
 
     m_timerManager.calc();
-    m_player.calc();
+
+    for (auto *player : m_players) {
+        player->calc();
+    }
 
     switch (m_stage) {
     case Stage::Intro:
@@ -73,8 +89,8 @@ bool RaceManager::isStageReached(Stage stage) const {
 }
 
 /// @addr{0x8053621C}
-MapdataJugemPoint *RaceManager::jugemPoint() const {
-    s8 jugemId = std::max<s8>(m_player.jugemId(), 0);
+MapdataJugemPoint *RaceManager::jugemPoint(size_t playerIdx) const {
+    s8 jugemId = std::max<s8>(player(playerIdx).jugemId(), 0);
     return System::CourseMap::Instance()->getJugemPoint(static_cast<u16>(jugemId));
 }
 
@@ -83,8 +99,13 @@ int RaceManager::getCountdownTimer() const {
     return STAGE_COUNTDOWN_DURATION - m_timer;
 }
 
-const RaceManager::Player &RaceManager::player() const {
-    return m_player;
+const RaceManager::Player &RaceManager::player(size_t idx) const {
+    ASSERT(idx < m_players.size());
+    return *m_players[idx];
+}
+
+size_t RaceManager::playerCount() const {
+    return m_players.size();
 }
 
 const TimerManager &RaceManager::timerManager() const {
@@ -101,36 +122,52 @@ u32 RaceManager::timer() const {
 
 /// @addr{0x80532084}
 RaceManager *RaceManager::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new RaceManager;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->raceManager);
+    context->raceManager = new RaceManager;
+    return context->raceManager;
 }
 
 RaceManager *RaceManager::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->raceManager;
 }
 
 /// @addr{0x805320D4}
 void RaceManager::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->raceManager);
+    auto *instance = context->raceManager;
+    context->raceManager = nullptr;
     delete instance;
 }
 
 /// @addr{0x805327A0}
-RaceManager::RaceManager() : m_stage(Stage::Intro), m_introTimer(0), m_timer(0) {}
+RaceManager::RaceManager() : m_stage(Stage::Intro), m_introTimer(0), m_timer(0) {
+    size_t playerCount = RaceConfig::Instance()->raceScenario().playerCount;
+    m_players = std::span<Player *>(new Player *[playerCount], playerCount);
+
+    for (size_t i = 0; i < playerCount; ++i) {
+        m_players[i] = new Player(i);
+    }
+}
 
 /// @addr{0x80532E3C}
 RaceManager::~RaceManager() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->raceManager) {
+        context->raceManager = nullptr;
         WARN("RaceManager instance not explicitly handled!");
     }
+
+    for (auto *player : m_players) {
+        delete player;
+    }
+
+    delete[] m_players.data();
 }
 
 /// @addr{0x80533ED8}
-RaceManager::Player::Player() {
+RaceManager::Player::Player(u8 idx) : m_idx(idx) {
     m_checkpointId = 0;
     m_raceCompletion = 0.0f;
     m_checkpointFactor = -1.0f;
@@ -147,7 +184,8 @@ RaceManager::Player::Player() {
 
     m_currentLap = 0;
     m_maxLap = 1;
-    m_inputs = &KPadDirector::Instance()->playerInput();
+    m_inputs = &KPadDirector::Instance()->playerInput(idx);
+    m_finished = false;
 }
 
 /// @addr{0x80534194}
@@ -155,7 +193,7 @@ void RaceManager::Player::init() {
     auto *courseMap = CourseMap::Instance();
 
     if (courseMap->getCheckPointCount() != 0 && courseMap->getCheckPathCount() != 0) {
-        const EGG::Vector3f &pos = Kart::KartObjectManager::Instance()->object(0)->pos();
+        const EGG::Vector3f &pos = Kart::KartObjectManager::Instance()->object(m_idx)->pos();
         f32 distanceRatio;
         s16 checkpointId = courseMap->findSector(pos, 0, distanceRatio);
 
@@ -169,7 +207,7 @@ void RaceManager::Player::init() {
 /// @addr{0x80535304}
 void RaceManager::Player::calc() {
     auto *courseMap = CourseMap::Instance();
-    const auto *kart = Kart::KartObjectManager::Instance()->object(0);
+    const auto *kart = Kart::KartObjectManager::Instance()->object(m_idx);
 
     if (courseMap->getCheckPointCount() == 0 || courseMap->getCheckPathCount() == 0 ||
             kart->state()->isBeforeRespawn()) {
@@ -241,6 +279,10 @@ const KPad *RaceManager::Player::inputs() const {
     return m_inputs;
 }
 
+bool RaceManager::Player::isFinished() const {
+    return m_finished;
+}
+
 /// @addr{0x80534DF8}
 MapdataCheckPoint *RaceManager::Player::calcCheckpoint(u16 checkpointId, f32 distanceRatio) {
     auto *courseMap = CourseMap::Instance();
@@ -321,7 +363,7 @@ void RaceManager::Player::incrementLap() {
         return;
     }
 
-    const auto *kart = Kart::KartObjectManager::Instance()->object(0);
+    const auto *kart = Kart::KartObjectManager::Instance()->object(m_idx);
     u16 addMs = CourseMap::Instance()->getCheckPointEntryOffsetMs(m_checkpointId, kart->pos(),
             kart->prevPos());
 
@@ -342,9 +384,8 @@ void RaceManager::Player::incrementLap() {
 /// @addr{0x805347F4}
 void RaceManager::Player::endRace(const Timer &finishTime) {
     m_raceTimer = finishTime;
-    RaceManager::Instance()->endPlayerRace(0);
+    m_finished = true;
+    RaceManager::Instance()->endPlayerRace(m_idx);
 }
 
-RaceManager *RaceManager::s_instance = nullptr; ///< @addr{0x809BD730}
-
 } // namespace System
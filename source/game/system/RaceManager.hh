@@ -14,12 +14,15 @@ namespace System {
 /// @details The physics engine leverages the RaceManager in order to determine what stage of the
 /// race we're in, as that affects several things like acceleration. This class also retrieves the
 /// player start position from CourseMap and communicates it to the physics engine.
+///
+/// Every player is tracked separately, but all of them share the stage and timers of the race. As
+/// every player is a time trial ghost, the race only finishes once all of them have finished.
 /// @nosubgrouping
 class RaceManager : EGG::Disposer {
 public:
     class Player {
     public:
-        Player();
+        Player(u8 idx);
         virtual ~Player() {}
 
         void init();
@@ -35,6 +38,7 @@ public:
         [[nodiscard]] const Timer &lapTimer(size_t idx) const;
         [[nodiscard]] const Timer &raceTimer() const;
         [[nodiscard]] const KPad *inputs() const;
+        [[nodiscard]] bool isFinished() const;
         /// @endGetters
 
     private:
@@ -46,6 +50,7 @@ public:
         void incrementLap();
         void endRace(const Timer &finishTime);
 
+        u8 m_idx; ///< The index of the player's kart.
         u16 m_checkpointId;
         f32 m_raceCompletion;
         f32 m_checkpointFactor; ///< The proportion of a lap for the current checkpoint
@@ -58,6 +63,7 @@ public:
         std::array<Timer, 3> m_lapTimers;
         Timer m_raceTimer;
         const KPad *m_inputs;
+        bool m_finished; ///< Whether the player has crossed the finish line on the final lap.
     };
 
     enum class Stage {
@@ -76,11 +82,12 @@ public:
     void calc();
 
     [[nodiscard]] bool isStageReached(Stage stage) const;
-    [[nodiscard]] MapdataJugemPoint *jugemPoint() const;
+    [[nodiscard]] MapdataJugemPoint *jugemPoint(size_t playerIdx) const;
 
     /// @beginGetters
     [[nodiscard]] int getCountdownTimer() const;
-    [[nodiscard]] const Player &player() const;
+    [[nodiscard]] const Player &player(size_t idx) const;
+    [[nodiscard]] size_t playerCount() const;
     [[nodiscard]] const TimerManager &timerManager() const;
     [[nodiscard]] Stage stage() const;
     [[nodiscard]] u32 timer() const;
@@ -94,15 +101,13 @@ private:
     RaceManager();
     ~RaceManager() override;
 
-    Player m_player;
+    std::span<Player *> m_players;
     TimerManager m_timerManager;
     Stage m_stage;
     u16 m_introTimer;
     u32 m_timer;
 
     static constexpr u16 STAGE_COUNTDOWN_DURATION = 240;
-
-    static RaceManager *s_instance; ///< @addr{0x809BD730}
 };
 
 } // namespace System
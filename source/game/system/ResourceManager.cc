@@ -2,6 +2,11 @@
 
 #include "game/system/RaceConfig.hh"
 
+#include <abstract/Archive.hh>
+#include <abstract/File.hh>
+
+#include <egg/core/EngineContext.hh>
+
 namespace System {
 
 #define ARCHIVE_COUNT 2
@@ -13,6 +18,11 @@ static const char *const RESOURCE_PATHS[] = {
 
 /// @addr{0x805411FC}
 void *ResourceManager::getFile(const char *filename, size_t *size, ArchiveId id) {
+    return getFile(EGG::Archive::Path(filename, EGG::Archive::Path::Hash(filename)), size, id);
+}
+
+/// @brief Retrieves a file by a path which has already been hashed, e.g. at compile time.
+void *ResourceManager::getFile(const EGG::Archive::Path &filename, size_t *size, ArchiveId id) {
     s32 idx = static_cast<s32>(id);
     return m_archives[idx]->isLoaded() ? m_archives[idx]->getFile(filename, size) : nullptr;
 }
@@ -24,30 +34,57 @@ void *ResourceManager::getBsp(Vehicle vehicle, size_t *size) {
     const char *name = GetVehicleName(vehicle);
     snprintf(buffer, sizeof(buffer), "/bsp/%s.bsp", name);
 
-    return m_archives[0]->isLoaded() ? m_archives[0]->getFile(buffer, size) : nullptr;
+    return getFile(buffer, size, ArchiveId::Core);
 }
 
 /// @addr{0x80540450}
-MultiDvdArchive *ResourceManager::load(s32 idx, const char *filename) {
+/// @details If a core pack is set, Kinoko maps it in place of the core archive.
+/// @param deferDecompression Kinoko addition. Leaves the archive to be decompressed and mounted
+/// with MultiDvdArchive::decompressDeferred and MultiDvdArchive::mountDeferred.
+MultiDvdArchive *ResourceManager::load(s32 idx, const char *filename, bool deferDecompression) {
     // Course has a dedicated load function, so we do not want it here
     ASSERT(idx != 1);
 
+    if (!filename && idx == static_cast<s32>(ArchiveId::Core) && HasCorePack()) {
+        if (!m_archives[idx]->isLoaded()) {
+            m_archives[idx]->loadImage(s_corePackPath);
+        }
+
+        return m_archives[idx];
+    }
+
     if (!filename) {
         filename = RESOURCE_PATHS[idx];
     }
 
     if (!m_archives[idx]->isLoaded() && filename) {
-        m_archives[idx]->load(filename);
+        if (deferDecompression) {
+            m_archives[idx]->loadDeferred(filename);
+        } else {
+            m_archives[idx]->load(filename);
+        }
     }
 
     return m_archives[idx];
 }
 
 /// @addr{0x80540760}
-MultiDvdArchive *ResourceManager::load(Course courseId) {
+/// @details If the CourseBundle holds the course, Kinoko mounts its image from the bundle instead.
+/// @param deferDecompression Kinoko addition, see the overload above.
+MultiDvdArchive *ResourceManager::load(Course courseId, bool deferDecompression) {
+    if (m_archives[1]->loadBundled(courseId)) {
+        return m_archives[1];
+    }
+
     char buffer[256];
     snprintf(buffer, sizeof(buffer), "Race/Course/%s", COURSE_NAMES[static_cast<s32>(courseId)]);
-    m_archives[1]->load(buffer);
+
+    if (deferDecompression) {
+        m_archives[1]->loadDeferred(buffer);
+    } else {
+        m_archives[1]->load(buffer);
+    }
+
     return m_archives[1];
 }
 
@@ -61,23 +98,44 @@ const char *ResourceManager::GetVehicleName(Vehicle vehicle) {
     return vehicle < Vehicle::Max ? VEHICLE_NAMES[static_cast<u8>(vehicle)] : nullptr;
 }
 
+/// @brief Kinoko addition to load the core archive from a core pack rather than Common.szs.
+/// @details A core pack is an uncompressed archive holding only the files which Kinoko reads from
+/// the core archive, generated by tools/generate_core_pack.py. It is mapped as is, so loading it
+/// costs neither a copy nor a decompression.
+/// @param path The path to the core pack, relative to the working directory.
+void ResourceManager::SetCorePack(const char *path) {
+    Abstract::File::MappedFile file(path);
+    auto *rawArchive = reinterpret_cast<const Abstract::ArchiveHandle::RawArchive *>(file.data());
+    if (file.size() < sizeof(*rawArchive) || !rawArchive->isValidSignature()) {
+        PANIC("%s is not an uncompressed archive!", path);
+    }
+
+    snprintf(s_corePackPath, sizeof(s_corePackPath), "%s", path);
+}
+
+bool ResourceManager::HasCorePack() {
+    return s_corePackPath[0] != '\0';
+}
+
 /// @addr{0x8053FC4C}
 ResourceManager *ResourceManager::CreateInstance() {
-    ASSERT(!s_instance);
-    s_instance = new ResourceManager;
-    return s_instance;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(!context->resourceManager);
+    context->resourceManager = new ResourceManager;
+    return context->resourceManager;
 }
 
 /// @addr{0x8053FC9C}
 void ResourceManager::DestroyInstance() {
-    ASSERT(s_instance);
-    auto *instance = s_instance;
-    s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    ASSERT(context->resourceManager);
+    auto *instance = context->resourceManager;
+    context->resourceManager = nullptr;
     delete instance;
 }
 
 ResourceManager *ResourceManager::Instance() {
-    return s_instance;
+    return Kinoko::EngineContext::Current()->resourceManager;
 }
 
 /// @addr{0x8053FCEC}
@@ -90,8 +148,9 @@ ResourceManager::ResourceManager() {
 
 /// @addr{0x8053FF1C}
 ResourceManager::~ResourceManager() {
-    if (s_instance) {
-        s_instance = nullptr;
+    auto *context = Kinoko::EngineContext::Current();
+    if (context->resourceManager) {
+        context->resourceManager = nullptr;
         WARN("ResourceManager instance not explicitly handled!");
     }
 }
@@ -104,6 +163,6 @@ MultiDvdArchive *ResourceManager::Create(u8 i) {
     }
 }
 
-ResourceManager *ResourceManager::s_instance = nullptr;
+char ResourceManager::s_corePackPath[256] = {};
 
 } // namespace System
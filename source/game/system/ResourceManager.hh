@@ -16,12 +16,16 @@ enum class ArchiveId {
 class ResourceManager : EGG::Disposer {
 public:
     void *getFile(const char *filename, size_t *size, ArchiveId id);
+    void *getFile(const EGG::Archive::Path &filename, size_t *size, ArchiveId id);
     void *getBsp(Vehicle vehicle, size_t *size);
-    [[nodiscard]] MultiDvdArchive *load(Course courseId);
-    [[nodiscard]] MultiDvdArchive *load(s32 idx, const char *filename);
+    [[nodiscard]] MultiDvdArchive *load(Course courseId, bool deferDecompression = false);
+    [[nodiscard]] MultiDvdArchive *load(s32 idx, const char *filename,
+            bool deferDecompression = false);
     void unmount(MultiDvdArchive *archive);
 
     [[nodiscard]] static const char *GetVehicleName(Vehicle vehicle);
+    static void SetCorePack(const char *path);
+    [[nodiscard]] static bool HasCorePack();
 
     static ResourceManager *CreateInstance();
     static void DestroyInstance();
@@ -36,7 +40,8 @@ private:
     MultiDvdArchive **m_archives;
 
     [[nodiscard]] static MultiDvdArchive *Create(u8 i);
-    static ResourceManager *s_instance; ///< @addr{0x809BD738}
+
+    static char s_corePackPath[256]; ///< Empty unless the core archive is loaded from a core pack.
 };
 
 } // namespace System
@@ -0,0 +1,190 @@
+#include "JobScheduler.hh"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Host {
+
+JobScheduler::JobScheduler() = default;
+
+JobScheduler::~JobScheduler() = default;
+
+/// @brief Queues up a job. Jobs are indexed in the order they are added.
+/// @param course The course the job races on.
+/// @param setup An identifier of everything else the job shares with other jobs, or 0 if none.
+/// @param cost The estimated cost of the job, such as its number of frames.
+void JobScheduler::add(Course course, u32 setup, u64 cost) {
+    m_jobs.push_back({course, setup, cost});
+}
+
+/// @brief Splits the jobs into a queue per worker.
+/// @param workerCount The number of workers. There are never more queues than jobs.
+void JobScheduler::plan(u32 workerCount) {
+    ASSERT(workerCount > 0);
+
+    u32 jobCount = m_jobs.size();
+    u32 queueCount = std::max<u32>(std::min(workerCount, jobCount), 1);
+
+    std::vector<u32> order(jobCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](u32 lhs, u32 rhs) {
+        const Job &l = m_jobs[lhs];
+        const Job &r = m_jobs[rhs];
+
+        if (l.course != r.course) {
+            return l.course < r.course;
+        }
+
+        if (l.setup != r.setup) {
+            return l.setup < r.setup;
+        }
+
+        return l.cost > r.cost;
+    });
+
+    u64 totalCost = 0;
+    for (const auto &job : m_jobs) {
+        totalCost += job.cost;
+    }
+
+    u64 share = std::max<u64>((totalCost + queueCount - 1) / queueCount, 1);
+
+    // A course group is only split when it would take more than its share of the batch
+    std::vector<Chunk> chunks;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Job &job = m_jobs[order[i]];
+        bool newCourse = i == 0 || m_jobs[order[i - 1]].course != job.course;
+
+        if (newCourse || chunks.back().cost + job.cost > share) {
+            chunks.push_back({{}, 0});
+        }
+
+        chunks.back().jobs.push_back(order[i]);
+        chunks.back().cost += job.cost;
+    }
+
+    auto byCost = [](const Chunk &lhs, const Chunk &rhs) { return lhs.cost > rhs.cost; };
+    std::stable_sort(chunks.begin(), chunks.end(), byCost);
+
+    m_queues.assign(queueCount, {});
+    m_plannedCosts.assign(queueCount, 0);
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        auto iter = std::min_element(m_plannedCosts.begin(), m_plannedCosts.end());
+        size_t worker = std::distance(m_plannedCosts.begin(), iter);
+        Chunk &chunk = chunks[i];
+
+        // If the chunk overflows even the least loaded worker, it only takes what fits in its share
+        // and the rest of the chunk is dispatched again
+        size_t count = 0;
+        u64 cost = 0;
+        while (count < chunk.jobs.size()) {
+            u64 jobCost = m_jobs[chunk.jobs[count]].cost;
+            if (count > 0 && *iter + cost + jobCost > share) {
+                break;
+            }
+
+            cost += jobCost;
+            ++count;
+        }
+
+        auto &queue = m_queues[worker];
+        queue.insert(queue.end(), chunk.jobs.begin(), chunk.jobs.begin() + count);
+        *iter += cost;
+
+        if (count < chunk.jobs.size()) {
+            Chunk rest = {{chunk.jobs.begin() + count, chunk.jobs.end()}, chunk.cost - cost};
+            auto pos = std::upper_bound(chunks.begin() + i + 1, chunks.end(), rest, byCost);
+            chunks.insert(pos, std::move(rest));
+        }
+    }
+}
+
+/// @brief Reports the planned queue of each worker.
+void JobScheduler::reportPlan() const {
+    u64 totalCost = 0;
+    for (u64 cost : m_plannedCosts) {
+        totalCost += cost;
+    }
+
+    u64 makespan = 0;
+    if (!m_plannedCosts.empty()) {
+        makespan = *std::max_element(m_plannedCosts.begin(), m_plannedCosts.end());
+    }
+
+    REPORT("Scheduled %zu jobs across %zu workers (estimated cost %llu, makespan %llu)",
+            m_jobs.size(), m_queues.size(), static_cast<unsigned long long>(totalCost),
+            static_cast<unsigned long long>(makespan));
+
+    for (size_t i = 0; i < m_queues.size(); ++i) {
+        const auto &queue = m_queues[i];
+
+        size_t courseCount = 0;
+        for (size_t j = 0; j < queue.size(); ++j) {
+            if (j == 0 || m_jobs[queue[j - 1]].course != m_jobs[queue[j]].course) {
+                ++courseCount;
+            }
+        }
+
+        f64 share = totalCost == 0 ? 0.0 : 100.0 * m_plannedCosts[i] / totalCost;
+        REPORT("  Worker %zu: %zu jobs, %zu courses, cost %llu (%.1f%%)", i, queue.size(),
+                courseCount, static_cast<unsigned long long>(m_plannedCosts[i]), share);
+    }
+}
+
+/// @brief Reports how busy each worker was during the last run of the pool.
+/// @details A worker is busy while running a job, so its utilization is its busy time over the
+/// wall-clock time of the whole run. Jobs a worker ran from another worker's queue were stolen.
+/// @param pool The pool which ran the planned queues.
+void JobScheduler::reportUtilization(const WorkerPool &pool) const {
+    std::vector<u64> busyTimes(m_queues.size(), 0);
+    std::vector<u32> jobCounts(m_queues.size(), 0);
+    std::vector<u32> stolenCounts(m_queues.size(), 0);
+
+    for (size_t i = 0; i < m_queues.size(); ++i) {
+        for (u32 job : m_queues[i]) {
+            if (!pool.isDone(job)) {
+                continue;
+            }
+
+            u32 worker = pool.worker(job);
+            busyTimes[worker] += pool.elapsed(job);
+            ++jobCounts[worker];
+
+            if (worker != i) {
+                ++stolenCounts[worker];
+            }
+        }
+    }
+
+    u64 wallTime = std::max<u64>(pool.wallTime(), 1);
+    u64 totalBusyTime = 0;
+    for (u64 busyTime : busyTimes) {
+        totalBusyTime += busyTime;
+    }
+
+    REPORT("Ran %zu jobs in %.3fs (%.1f%% utilization)", m_jobs.size(),
+            static_cast<f64>(wallTime) / 1e9,
+            100.0 * totalBusyTime / (static_cast<f64>(wallTime) * m_queues.size()));
+
+    for (size_t i = 0; i < m_queues.size(); ++i) {
+        REPORT("  Worker %zu: %u jobs (%u stolen), busy %.3fs (%.1f%%)", i, jobCounts[i],
+                stolenCounts[i], static_cast<f64>(busyTimes[i]) / 1e9,
+                100.0 * busyTimes[i] / wallTime);
+    }
+}
+
+/// @brief Estimates the number of frames a ghost's race takes from its finishing time.
+/// @details The race timer starts after the intro and countdown, which always take the same number
+/// of frames. The race itself runs at 59.94 frames per second.
+/// @param raceTime The finishing time of the ghost.
+/// @return The estimated number of frames up to the finish.
+u64 JobScheduler::EstimateFrameCount(const System::Timer &raceTime) {
+    constexpr u64 INTRO_FRAME_COUNT = 172;
+    constexpr u64 COUNTDOWN_FRAME_COUNT = 240;
+
+    u64 ms = (static_cast<u64>(raceTime.min) * 60 + raceTime.sec) * 1000 + raceTime.mil;
+    return INTRO_FRAME_COUNT + COUNTDOWN_FRAME_COUNT + ms * 5994 / 100000;
+}
+
+} // namespace Host
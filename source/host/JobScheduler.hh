@@ -0,0 +1,59 @@
+#pragma once
+
+#include "host/WorkerPool.hh"
+
+#include <game/system/TimerManager.hh>
+
+#include <vector>
+
+namespace Host {
+
+/// @brief Plans which worker runs each job of a batch, and in which order.
+/// @details Each job has a course, a setup and an estimated cost, which are all known from the
+/// RKG header before any job runs. Jobs on the same course are kept together, so that a worker
+/// loads each archive and builds each KCL as few times as possible. Within a course, jobs which
+/// share a setup are kept adjacent, so that the test driver can restart them from a snapshot.
+///
+/// To minimize the makespan, each course group is first split into chunks no costlier than an even
+/// share of the batch, so that a single large course cannot hold up the whole batch. The chunks are
+/// then dispatched longest-first, each to the worker with the least planned cost so far. A chunk
+/// which would take that worker past its share is split again, and only the part which fits is
+/// dispatched. Each worker's queue runs its costliest jobs first, leaving the cheap jobs at the
+/// back for the Host::WorkerPool to steal when an estimate turns out wrong.
+class JobScheduler {
+public:
+    JobScheduler();
+    ~JobScheduler();
+
+    void add(Course course, u32 setup, u64 cost);
+    void plan(u32 workerCount);
+
+    void reportPlan() const;
+    void reportUtilization(const WorkerPool &pool) const;
+
+    /// @brief The jobs each worker runs, in order. Only valid after planning.
+    [[nodiscard]] const std::vector<std::vector<u32>> &queues() const {
+        return m_queues;
+    }
+
+    [[nodiscard]] static u64 EstimateFrameCount(const System::Timer &raceTime);
+
+private:
+    struct Job {
+        Course course;
+        u32 setup; ///< Jobs with the same setup can share a warm restart.
+        u64 cost;
+    };
+
+    /// @brief A run of jobs on the same course which is dispatched to a single worker.
+    struct Chunk {
+        std::vector<u32> jobs;
+        u64 cost;
+    };
+
+    std::vector<Job> m_jobs;
+    std::vector<std::vector<u32>> m_queues;
+    std::vector<u64> m_plannedCosts; ///< The estimated cost of each worker's queue.
+};
+
+} // namespace Host
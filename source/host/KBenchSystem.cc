@@ -0,0 +1,224 @@
+#include "KBenchSystem.hh"
+
+#include "host/Option.hh"
+
+#include <egg/core/Decomp.hh>
+
+#include <game/system/GhostFile.hh>
+
+#include <abstract/File.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+
+static u64 Now() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+/// @brief Finds the compressed data in a file.
+/// @return The start of the compressed data, or nullptr if the file holds none.
+static const u8 *FindCompressedData(const u8 *file, size_t size) {
+    constexpr size_t YAZ_HEADER_SIZE = 0x10;
+    constexpr size_t RKG_COMPRESSED_OFFSET = System::RKG_HEADER_SIZE + 0x4;
+
+    if (size >= YAZ_HEADER_SIZE && EGG::Decomp::GetExpandSize(file) >= 0) {
+        return file;
+    }
+
+    // Compressed ghosts hold the size of the compressed data, followed by the data itself
+    if (size >= RKG_COMPRESSED_OFFSET + YAZ_HEADER_SIZE && memcmp(file, "RKGD", 4) == 0 &&
+            EGG::Decomp::GetExpandSize(file + RKG_COMPRESSED_OFFSET) >= 0) {
+        return file + RKG_COMPRESSED_OFFSET;
+    }
+
+    return nullptr;
+}
+
+/// @brief Decodes the data repeatedly for at least the given time.
+/// @return The average time per decode, in nanoseconds.
+static u64 TimeDecode(s32 (*decode)(const u8 *, u8 *), const u8 *src, u8 *dst, u64 minTime) {
+    u64 start = Now();
+    u64 elapsed = 0;
+    u32 count = 0;
+
+    do {
+        decode(src, dst);
+        ++count;
+        elapsed = Now() - start;
+    } while (elapsed < minTime);
+
+    return elapsed / count;
+}
+
+/// @brief Initializes the system.
+/// @details Nothing is benchmarked inside of a scene, so there is nothing to initialize.
+void KBenchSystem::init() {
+    ASSERT(!m_inputs.empty());
+}
+
+/// @brief Executes a frame.
+/// @details The benchmarks don't run in frames, so this does nothing.
+void KBenchSystem::calc() {}
+
+/// @brief Executes a run.
+/// @details A run benchmarks both decoders on every input.
+/// @return Whether both decoders produced the same output for every input.
+bool KBenchSystem::run() {
+    bool success = true;
+    size_t totalSize = 0;
+    u64 totalFast = 0;
+    u64 totalBytewise = 0;
+
+    for (const auto &input : m_inputs) {
+        size_t expandSize;
+        DecodeTimes times;
+        if (!benchDecode(input, expandSize, times)) {
+            success = false;
+            continue;
+        }
+
+        totalSize += expandSize;
+        totalFast += times.fast;
+        totalBytewise += times.bytewise;
+    }
+
+    if (totalFast > 0 && totalBytewise > 0) {
+        // Bytes per nanosecond is the same as gigabytes per second
+        f64 bytewiseRate = static_cast<f64>(totalSize) / totalBytewise;
+        f64 fastRate = static_cast<f64>(totalSize) / totalFast;
+        REPORT("Total: %zu bytes | bytewise %.3f GB/s | fast %.3f GB/s | %.2fx", totalSize,
+                bytewiseRate, fastRate, fastRate / bytewiseRate);
+    }
+
+    return success;
+}
+
+/// @brief Parses non-generic command line options.
+/// @details The only accepted option is the batch flag, which can be passed multiple times.
+/// @param argc The number of arguments.
+/// @param argv The arguments.
+void KBenchSystem::parseOptions(int argc, char **argv) {
+    if (argc < 2) {
+        PANIC("Expected batch argument!");
+    }
+
+    for (int i = 0; i < argc; ++i) {
+        std::optional<Host::EOption> flag = Host::Option::CheckFlag(argv[i]);
+        if (!flag || *flag == Host::EOption::Invalid) {
+            WARN("Expected a flag! Got: %s", argv[i]);
+            continue;
+        }
+
+        switch (*flag) {
+        case Host::EOption::Batch: {
+            ASSERT(i + 1 < argc);
+            addInputs(argv[++i]);
+        } break;
+        case Host::EOption::Invalid:
+        default:
+            PANIC("Invalid flag!");
+            break;
+        }
+    }
+}
+
+KBenchSystem *KBenchSystem::CreateInstance() {
+    ASSERT(!s_instance);
+    s_instance = new KBenchSystem;
+    return static_cast<KBenchSystem *>(s_instance);
+}
+
+void KBenchSystem::DestroyInstance() {
+    ASSERT(s_instance);
+    auto *instance = s_instance;
+    s_instance = nullptr;
+    delete instance;
+}
+
+KBenchSystem *KBenchSystem::Instance() {
+    return static_cast<KBenchSystem *>(s_instance);
+}
+
+KBenchSystem::KBenchSystem() = default;
+
+KBenchSystem::~KBenchSystem() {
+    if (s_instance) {
+        s_instance = nullptr;
+        WARN("KBenchSystem instance not explicitly handled!");
+    }
+}
+
+/// @brief Queues up the inputs to benchmark.
+/// @param path Either a file, or a directory whose files are all queued.
+void KBenchSystem::addInputs(const char *path) {
+    // Resolve the path like the inputs are loaded
+    char resolved[256];
+    Abstract::File::ResolvePath(path, resolved, sizeof(resolved));
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(resolved, ec)) {
+        m_inputs.emplace_back(path);
+        return;
+    }
+
+    std::vector<std::string> paths;
+    auto iter = std::filesystem::directory_iterator(resolved, ec);
+    for (; !ec && iter != std::filesystem::directory_iterator(); iter.increment(ec)) {
+        // Keep the path as given, as each input's path is resolved again when it is loaded
+        if (iter->is_regular_file(ec)) {
+            paths.push_back((std::filesystem::path(path) / iter->path().filename()).string());
+        }
+    }
+
+    if (ec) {
+        PANIC("Failed to read directory %s!", path);
+    }
+
+    // Directory iteration order is unspecified, so sort for reproducible results
+    std::sort(paths.begin(), paths.end());
+    m_inputs.insert(m_inputs.end(), paths.begin(), paths.end());
+}
+
+/// @brief Decodes an input with both decoders and compares their output.
+/// @param path The path to the input.
+/// @param expandSize Receives the size of the decompressed data.
+/// @param times Receives the time per decode of each decoder.
+/// @return Whether the input holds compressed data and both decoders produced the same output.
+bool KBenchSystem::benchDecode(const std::string &path, size_t &expandSize,
+        DecodeTimes &times) const {
+    Abstract::File::MappedFile file(path.c_str());
+
+    const u8 *src = FindCompressedData(file.data(), file.size());
+    if (!src) {
+        REPORT("%s: Skipped, as it holds no compressed data", path.c_str());
+        expandSize = 0;
+        times = {0, 0};
+        return true;
+    }
+
+    expandSize = EGG::Decomp::GetExpandSize(src);
+
+    // The images of course archives don't fit in the engine heaps, so allocate them separately
+    u8 *fastDst = reinterpret_cast<u8 *>(std::malloc(expandSize));
+    u8 *bytewiseDst = reinterpret_cast<u8 *>(std::malloc(expandSize));
+
+    times.fast = TimeDecode(EGG::Decomp::DecodeSZS, src, fastDst, MIN_DECODE_TIME);
+    times.bytewise = TimeDecode(EGG::Decomp::DecodeSZSBytewise, src, bytewiseDst, MIN_DECODE_TIME);
+
+    bool match = memcmp(fastDst, bytewiseDst, expandSize) == 0;
+    if (!match) {
+        REPORT("%s: MISMATCH! The decoders produced different output", path.c_str());
+    } else {
+        REPORT("%s: %zu bytes | bytewise %.3f ms | fast %.3f ms | %.2fx", path.c_str(), expandSize,
+                static_cast<f64>(times.bytewise) / 1e6, static_cast<f64>(times.fast) / 1e6,
+                static_cast<f64>(times.bytewise) / std::max<u64>(times.fast, 1));
+    }
+
+    std::free(fastDst);
+    std::free(bytewiseDst);
+
+    return match;
+}
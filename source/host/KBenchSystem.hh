@@ -0,0 +1,43 @@
+#pragma once
+
+#include "host/KSystem.hh"
+
+#include <string>
+#include <vector>
+
+/// @brief Kinoko system designed to benchmark the engine's hot paths outside of a race.
+/// @details Decompresses each input with both EGG::Decomp::DecodeSZS and the game's bytewise
+/// decoder, verifies that their output is identical, and reports the throughput of each. Inputs are
+/// SZS archives, or compressed RKG files such as the ones in the samples directory, whose input
+/// data is compressed with the same scheme.
+class KBenchSystem final : public KSystem {
+public:
+    void init() override;
+    void calc() override;
+    bool run() override;
+    void parseOptions(int argc, char **argv) override;
+
+    static KBenchSystem *CreateInstance();
+    static void DestroyInstance();
+    static KBenchSystem *Instance();
+
+private:
+    /// @brief The time spent decoding an input with each decoder.
+    struct DecodeTimes {
+        u64 fast;     ///< Nanoseconds per decode with DecodeSZS.
+        u64 bytewise; ///< Nanoseconds per decode with DecodeSZSBytewise.
+    };
+
+    KBenchSystem();
+    KBenchSystem(const KBenchSystem &) = delete;
+    KBenchSystem(KBenchSystem &&) = delete;
+    ~KBenchSystem() override;
+
+    void addInputs(const char *path);
+    bool benchDecode(const std::string &path, size_t &expandSize, DecodeTimes &times) const;
+
+    /// @brief The minimum time to spend decoding each input with each decoder, in nanoseconds.
+    static constexpr u64 MIN_DECODE_TIME = 50000000;
+
+    std::vector<std::string> m_inputs;
+};
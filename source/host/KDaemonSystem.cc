@@ -0,0 +1,554 @@
+#include "KDaemonSystem.hh"
+
+#include "host/Option.hh"
+#include "host/SceneCreatorDynamic.hh"
+
+#include <game/field/KColDataCache.hh>
+#include <game/kart/KartObjectManager.hh>
+#include <game/system/ArchiveCache.hh>
+#include <game/system/CourseBundle.hh>
+#include <game/system/KPadDirector.hh>
+#include <game/system/RaceManager.hh>
+#include <game/system/ResourceManager.hh>
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define DAEMON_SOCKETS
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/// @brief Guards against allocating absurd amounts of memory for malformed requests.
+static constexpr u32 MAX_PAYLOAD_SIZE = 0x100000;
+
+static u32 TimerToMilliseconds(const System::Timer &timer) {
+    return timer.min * 60000 + timer.sec * 1000 + timer.mil;
+}
+
+static void GetCourseArchivePath(Course course, char *buffer, size_t size) {
+    snprintf(buffer, size, "Race/Course/%s.szs", COURSE_NAMES[static_cast<s32>(course)]);
+}
+
+#ifdef DAEMON_SOCKETS
+static bool ReadAll(int fd, void *buffer, size_t size) {
+    u8 *dst = reinterpret_cast<u8 *>(buffer);
+    while (size > 0) {
+        ssize_t count = read(fd, dst, size);
+        if (count <= 0) {
+            return false;
+        }
+
+        dst += count;
+        size -= count;
+    }
+
+    return true;
+}
+
+static bool WriteAll(int fd, const void *buffer, size_t size) {
+    const u8 *src = reinterpret_cast<const u8 *>(buffer);
+    while (size > 0) {
+        ssize_t count = write(fd, src, size);
+        if (count <= 0) {
+            return false;
+        }
+
+        src += count;
+        size -= count;
+    }
+
+    return true;
+}
+#endif
+
+/// @brief Initializes the system.
+/// @details This creates the socket and decompresses Common.szs, unless a core pack is set. Scenes
+/// are only initialized once the first job arrives.
+void KDaemonSystem::init() {
+#ifdef DAEMON_SOCKETS
+    ASSERT(m_socketPath);
+
+    auto *sceneCreator = new Host::SceneCreatorDynamic;
+    m_sceneMgr = new EGG::SceneManager(sceneCreator);
+
+    // The ghost must outlive the race scenes, so it is allocated before any scene exists
+    m_ghost = new System::RawGhostFile;
+
+    System::RaceConfig::RegisterInitCallback(OnInit, nullptr);
+    if (!System::ResourceManager::HasCorePack()) {
+        System::ArchiveCache::Load("Race/Common.szs");
+    }
+    Field::KColDataCache::Enable();
+
+    // Writing to a client which disconnected would otherwise kill the daemon
+    signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (strlen(m_socketPath) >= sizeof(addr.sun_path)) {
+        PANIC("Socket path %s is too long!", m_socketPath);
+    }
+    strncpy(addr.sun_path, m_socketPath, sizeof(addr.sun_path) - 1);
+
+    // Remove the socket left behind by a previous daemon, but never an unrelated file
+    struct stat st;
+    if (stat(m_socketPath, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            PANIC("%s already exists and is not a socket!", m_socketPath);
+        }
+
+        unlink(m_socketPath);
+    }
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        PANIC("Failed to create socket!");
+    }
+
+    if (bind(m_listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        PANIC("Failed to bind socket to %s!", m_socketPath);
+    }
+
+    if (listen(m_listenFd, 1) != 0) {
+        PANIC("Failed to listen on %s!", m_socketPath);
+    }
+
+    REPORT("Listening on %s", m_socketPath);
+#else
+    PANIC("Daemon mode requires Unix domain sockets!");
+#endif
+}
+
+/// @brief Executes a frame.
+void KDaemonSystem::calc() {
+    m_sceneMgr->calc();
+    ++m_frame;
+}
+
+/// @brief Executes a run.
+/// @details A run consists of serving clients until one of them requests a shutdown.
+/// @return Whether the daemon shut down cleanly.
+bool KDaemonSystem::run() {
+#ifdef DAEMON_SOCKETS
+    while (true) {
+        m_clientFd = accept(m_listenFd, nullptr, nullptr);
+        if (m_clientFd < 0) {
+            WARN("Failed to accept client!");
+            continue;
+        }
+
+        bool serving = serveClient();
+        close(m_clientFd);
+        m_clientFd = -1;
+
+        if (!serving) {
+            break;
+        }
+    }
+
+    close(m_listenFd);
+    m_listenFd = -1;
+    unlink(m_socketPath);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// @brief Parses non-generic command line options.
+/// @details The only currently accepted option is the socket flag.
+/// @param argc The number of arguments.
+/// @param argv The arguments.
+void KDaemonSystem::parseOptions(int argc, char **argv) {
+    if (argc < 2) {
+        PANIC("Expected socket argument!");
+    }
+
+    for (int i = 0; i < argc; ++i) {
+        std::optional<Host::EOption> flag = Host::Option::CheckFlag(argv[i]);
+        if (!flag || *flag == Host::EOption::Invalid) {
+            WARN("Expected a flag! Got: %s", argv[i]);
+            continue;
+        }
+
+        switch (*flag) {
+        case Host::EOption::Socket: {
+            ASSERT(i + 1 < argc);
+            m_socketPath = argv[++i];
+        } break;
+        case Host::EOption::Invalid:
+        default:
+            PANIC("Invalid flag!");
+            break;
+        }
+    }
+}
+
+KDaemonSystem *KDaemonSystem::CreateInstance() {
+    ASSERT(!s_instance);
+    s_instance = new KDaemonSystem;
+    return static_cast<KDaemonSystem *>(s_instance);
+}
+
+void KDaemonSystem::DestroyInstance() {
+    ASSERT(s_instance);
+    auto *instance = s_instance;
+    s_instance = nullptr;
+    delete instance;
+}
+
+KDaemonSystem *KDaemonSystem::Instance() {
+    return static_cast<KDaemonSystem *>(s_instance);
+}
+
+KDaemonSystem::KDaemonSystem()
+    : m_sceneMgr(nullptr), m_socketPath(nullptr), m_listenFd(-1), m_clientFd(-1), m_frame(0),
+      m_ghost(nullptr), m_player(), m_course(Course::GCN_Mario_Circuit), m_warmCourses(),
+      m_warmCourseCount(0) {}
+
+KDaemonSystem::~KDaemonSystem() {
+    if (s_instance) {
+        s_instance = nullptr;
+        WARN("KDaemonSystem instance not explicitly handled!");
+    }
+
+    delete m_sceneMgr;
+    delete m_ghost;
+}
+
+/// @brief Handles requests from the connected client until it disconnects.
+/// @return Whether the daemon should keep accepting clients.
+bool KDaemonSystem::serveClient() {
+#ifdef DAEMON_SOCKETS
+    while (true) {
+        MessageHeader header;
+        if (!ReadAll(m_clientFd, &header, sizeof(header))) {
+            return true;
+        }
+
+        if (static_cast<RequestType>(header.type) == RequestType::Shutdown) {
+            return false;
+        }
+
+        // We cannot find the start of the next request, so the client is dropped
+        if (header.size > MAX_PAYLOAD_SIZE) {
+            sendError("Request payload is too large!");
+            return true;
+        }
+
+        // The payload is allocated outside of the engine heaps, as the scenes are recreated while
+        // it is in use
+        u8 *payload = reinterpret_cast<u8 *>(std::malloc(header.size));
+        bool connected = ReadAll(m_clientFd, payload, header.size) &&
+                handleRequest(header, payload);
+        std::free(payload);
+
+        if (!connected) {
+            return true;
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+/// @brief Runs a single job.
+/// @return Whether the client is still connected.
+bool KDaemonSystem::handleRequest(const MessageHeader &header, const u8 *payload) {
+    switch (static_cast<RequestType>(header.type)) {
+    case RequestType::Replay:
+        return runReplay(header, payload, header.size, std::numeric_limits<u32>::max());
+    case RequestType::ReplayToFrame: {
+        if (header.size < sizeof(u32)) {
+            return sendError("Expected a target frame!");
+        }
+
+        u32 targetFrame;
+        memcpy(&targetFrame, payload, sizeof(u32));
+        return runReplay(header, payload + sizeof(u32), header.size - sizeof(u32), targetFrame);
+    }
+    case RequestType::Inputs:
+        return runInputs(header, payload, header.size);
+    default:
+        return sendError("Unknown request type!");
+    }
+}
+
+/// @brief Replays a ghost until the race ends or the target frame is reached.
+/// @details A replay running to the end responds with a Result, while a replay stopping at a target
+/// frame responds with the kart's State at that frame.
+/// @return Whether the client is still connected.
+bool KDaemonSystem::runReplay(const MessageHeader &header, const u8 *rkg, u32 size,
+        u32 targetFrame) {
+    if (!loadGhost(rkg, size)) {
+        return sendError("Invalid ghost!");
+    }
+
+    System::GhostFile ghost(*m_ghost);
+    m_player.type = System::RaceConfig::Player::Type::Ghost;
+    startRace(ghost.course());
+
+    bool streamStates = header.flags & static_cast<u16>(RequestFlag::StreamStates);
+    while (m_frame < targetFrame && !calcEnd()) {
+        calc();
+
+        if (streamStates && !sendState(m_frame)) {
+            return false;
+        }
+    }
+
+    if (static_cast<RequestType>(header.type) == RequestType::ReplayToFrame) {
+        return sendState(m_frame);
+    }
+
+    const auto *raceManager = System::RaceManager::Instance();
+    bool finished = raceManager->stage() == System::RaceManager::Stage::FinishGlobal;
+
+    Result result;
+    result.frameCount = m_frame;
+    result.raceTime = finished ? TimerToMilliseconds(raceManager->player(0).raceTimer()) : 0;
+    result.expectedTime = TimerToMilliseconds(ghost.raceTimer());
+    result.desyncingTimerIdx = finished ? getDesyncingTimerIdx() : -1;
+
+    if (!finished) {
+        result.status = Status::Unfinished;
+    } else {
+        result.status = result.desyncingTimerIdx == -1 ? Status::Sync : Status::Desync;
+    }
+
+    return sendResult(result);
+}
+
+/// @brief Runs a race driven by an input sequence.
+/// @return Whether the client is still connected.
+bool KDaemonSystem::runInputs(const MessageHeader &header, const u8 *payload, u32 size) {
+    if (size < sizeof(InputsHeader)) {
+        return sendError("Expected an inputs header!");
+    }
+
+    InputsHeader inputsHeader;
+    memcpy(&inputsHeader, payload, sizeof(InputsHeader));
+
+    if (size != sizeof(InputsHeader) + inputsHeader.frameCount * sizeof(InputFrame)) {
+        return sendError("Input sequence size mismatch!");
+    }
+
+    Course course = static_cast<Course>(inputsHeader.course);
+    Character character = static_cast<Character>(inputsHeader.character);
+    Vehicle vehicle = static_cast<Vehicle>(inputsHeader.vehicle);
+
+    if (inputsHeader.course >= std::size(COURSE_NAMES) || character >= Character::Max ||
+            vehicle >= Vehicle::Max) {
+        return sendError("Invalid course, character, or vehicle!");
+    }
+
+    if (CharacterToWeight(character) != VehicleToWeight(vehicle)) {
+        return sendError("Character/Bike weight class mismatch!");
+    }
+
+    m_player.type = System::RaceConfig::Player::Type::Local;
+    m_player.character = character;
+    m_player.vehicle = vehicle;
+    m_player.driftIsAuto = inputsHeader.driftIsAuto != 0;
+    startRace(course);
+
+    auto *controller = System::KPadDirector::Instance()->hostController();
+    const u8 *frames = payload + sizeof(InputsHeader);
+    bool streamStates = header.flags & static_cast<u16>(RequestFlag::StreamStates);
+
+    for (u32 i = 0; i < inputsHeader.frameCount && !calcEnd(); ++i) {
+        InputFrame frame;
+        memcpy(&frame, frames + i * sizeof(InputFrame), sizeof(InputFrame));
+
+        if (!controller->setInputsRawStick(frame.buttons, frame.stickX, frame.stickY,
+                    static_cast<System::Trick>(frame.trick))) {
+            return sendError("Invalid inputs!");
+        }
+
+        calc();
+
+        if (streamStates && !sendState(m_frame)) {
+            return false;
+        }
+    }
+
+    const auto *raceManager = System::RaceManager::Instance();
+    bool finished = raceManager->stage() == System::RaceManager::Stage::FinishGlobal;
+
+    Result result;
+    result.status = finished ? Status::Finished : Status::Unfinished;
+    result.frameCount = m_frame;
+    result.raceTime = finished ? TimerToMilliseconds(raceManager->player(0).raceTimer()) : 0;
+    result.expectedTime = 0;
+    result.desyncingTimerIdx = -1;
+
+    return sendResult(result);
+}
+
+/// @brief Validates and decompresses the ghost of a job.
+/// @return Whether the buffer holds a ghost for a supported course.
+bool KDaemonSystem::loadGhost(const u8 *rkg, u32 size) {
+    if (!m_ghost->tryInit(rkg, size)) {
+        return false;
+    }
+
+    return static_cast<size_t>(System::GhostFile(*m_ghost).course()) < std::size(COURSE_NAMES);
+}
+
+/// @brief Tears down the previous race, if any, and starts a new one on the given course.
+void KDaemonSystem::startRace(Course course) {
+    if (m_sceneMgr->currentScene()) {
+        // TODO: Use a system heap! We currently have a dependency on the scene heap
+        m_sceneMgr->destroyScene(m_sceneMgr->currentScene());
+    }
+
+    m_course = course;
+    warmCourse(course);
+
+    if (m_sceneMgr->currentScene()) {
+        m_sceneMgr->createScene(2, m_sceneMgr->currentScene());
+    } else {
+        m_sceneMgr->changeScene(0);
+    }
+
+    m_frame = 0;
+}
+
+/// @brief Ensures the course archive is cached, evicting the least recently used course if needed.
+/// @details The race scene must not be active, as a mounted archive cannot be evicted.
+void KDaemonSystem::warmCourse(Course course) {
+    char buffer[256];
+
+    auto iter = std::find(m_warmCourses.begin(), m_warmCourses.begin() + m_warmCourseCount, course);
+    if (iter == m_warmCourses.begin() + m_warmCourseCount) {
+        if (m_warmCourseCount == MAX_WARM_COURSES) {
+            GetCourseArchivePath(m_warmCourses[--m_warmCourseCount], buffer, sizeof(buffer));
+            System::ArchiveCache::Evict(buffer);
+
+            // The cached KCL arrays of the evicted archive would otherwise dangle
+            Field::KColDataCache::Clear();
+        }
+
+        iter = m_warmCourses.begin() + m_warmCourseCount++;
+        *iter = course;
+    }
+
+    // Move the course to the front, as it is now the most recently used
+    std::rotate(m_warmCourses.begin(), iter, iter + 1);
+
+    // Bundled courses are mounted from the bundle, so there is nothing to decompress
+    if (!System::CourseBundle::Contains(course)) {
+        GetCourseArchivePath(course, buffer, sizeof(buffer));
+        System::ArchiveCache::Load(buffer);
+    }
+}
+
+/// @brief Determines whether or not the race should end.
+bool KDaemonSystem::calcEnd() const {
+    constexpr u16 MAX_MINUTE_COUNT = 10;
+
+    const auto *raceManager = System::RaceManager::Instance();
+    if (raceManager->stage() == System::RaceManager::Stage::FinishGlobal) {
+        return true;
+    }
+
+    return raceManager->timerManager().currentTimer().min >= MAX_MINUTE_COUNT;
+}
+
+/// @brief Finds the desyncing timer index of the replayed ghost, if one exists.
+/// @return -1 if there's no desync, 0 if the final timer desyncs, and 1+ if a lap timer desyncs.
+s32 KDaemonSystem::getDesyncingTimerIdx() const {
+    System::GhostFile ghost(*m_ghost);
+    const auto &player = System::RaceManager::Instance()->player(0);
+    if (ghost.raceTimer() != player.raceTimer()) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        if (ghost.lapTimer(i) != player.getLapSplit(i + 1)) {
+            return i + 1;
+        }
+    }
+
+    return -1;
+}
+
+bool KDaemonSystem::sendState(u32 frame) {
+    auto *object = Kart::KartObjectManager::Instance()->object(0);
+    const auto &player = System::RaceManager::Instance()->player(0);
+
+    auto copyVec = [](f32 *dst, const EGG::Vector3f &v) {
+        dst[0] = v.x;
+        dst[1] = v.y;
+        dst[2] = v.z;
+    };
+
+    auto copyQuat = [&](f32 *dst, const EGG::Quatf &q) {
+        copyVec(dst, q.v);
+        dst[3] = q.w;
+    };
+
+    KartState state = {};
+    state.frame = frame;
+    copyVec(state.pos, object->pos());
+    copyQuat(state.fullRot, object->fullRot());
+    copyVec(state.extVel, object->extVel());
+    copyVec(state.intVel, object->intVel());
+    state.speed = object->speed();
+    state.acceleration = object->acceleration();
+    state.softSpeedLimit = object->softSpeedLimit();
+    copyQuat(state.mainRot, object->mainRot());
+    copyVec(state.angVel2, object->angVel2());
+    state.raceCompletion = player.raceCompletion();
+    state.checkpointId = player.checkpointId();
+    state.jugemId = player.jugemId();
+
+    return send(ResponseType::State, &state, sizeof(state));
+}
+
+bool KDaemonSystem::sendResult(const Result &result) {
+    return send(ResponseType::Result, &result, sizeof(result));
+}
+
+bool KDaemonSystem::sendError(const char *msg) {
+    return send(ResponseType::Error, msg, strlen(msg));
+}
+
+/// @return Whether the client is still connected.
+bool KDaemonSystem::send(ResponseType type, const void *payload, u32 size) {
+#ifdef DAEMON_SOCKETS
+    MessageHeader header;
+    header.type = static_cast<u16>(type);
+    header.flags = 0;
+    header.size = size;
+
+    return WriteAll(m_clientFd, &header, sizeof(header)) && WriteAll(m_clientFd, payload, size);
+#else
+    (void)type;
+    (void)payload;
+    (void)size;
+    return false;
+#endif
+}
+
+/// @brief Initializes the race configuration for the current job.
+/// @param config The race configuration instance.
+/// @param arg Unused optional argument.
+void KDaemonSystem::OnInit(System::RaceConfig *config, void * /* arg */) {
+    auto *daemon = Instance();
+    auto &scenario = config->raceScenario();
+
+    if (daemon->m_player.type == System::RaceConfig::Player::Type::Ghost) {
+        config->setGhost(0, daemon->m_ghost->buffer());
+        scenario.players[0].type = System::RaceConfig::Player::Type::Ghost;
+    } else {
+        scenario.course = daemon->m_course;
+        scenario.players[0] = daemon->m_player;
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "host/KSystem.hh"
+
+#include <egg/core/SceneManager.hh>
+
+#include <game/system/RaceConfig.hh>
+
+/// @brief Kinoko system designed to serve simulation jobs over a Unix domain socket.
+/// @details The daemon listens on the socket passed with the socket flag and serves one client at a
+/// time, running each request as its own race. Common.szs and the most recently used course
+/// archives stay decompressed in the System::ArchiveCache between jobs, so that the cost of a job
+/// is only the simulation itself.
+///
+/// Every message, in either direction, starts with a MessageHeader followed by `size` bytes of
+/// payload. All fields are in the host's byte order, as the socket is local.
+/// Request  | Payload | Responses
+///------------- | ------------- | -------------
+/// Replay | An RKG file | Result
+/// Inputs | An InputsHeader, followed by `frameCount` InputFrames | Result
+/// ReplayToFrame | The frame to stop at as a u32, followed by an RKG file | State
+/// Shutdown | None | None
+///
+/// When a request sets the StreamStates flag, a State message is also sent after every frame. A
+/// request which cannot be run is answered with an Error message holding a description of the
+/// problem.
+class KDaemonSystem final : public KSystem {
+public:
+    void init() override;
+    void calc() override;
+    bool run() override;
+    void parseOptions(int argc, char **argv) override;
+
+    static KDaemonSystem *CreateInstance();
+    static void DestroyInstance();
+    static KDaemonSystem *Instance();
+
+private:
+    enum class RequestType : u16 {
+        Replay = 0,
+        Inputs = 1,
+        ReplayToFrame = 2,
+        Shutdown = 3,
+    };
+
+    enum class ResponseType : u16 {
+        State = 0,
+        Result = 1,
+        Error = 2,
+    };
+
+    enum class Status : u32 {
+        Sync = 0,       ///< The ghost finished with the times stored in its file.
+        Desync = 1,     ///< The ghost finished, but with different times.
+        Finished = 2,   ///< The input sequence finished the race.
+        Unfinished = 3, ///< The race did not finish.
+    };
+
+    /// @brief Flags set on a request.
+    enum class RequestFlag : u16 {
+        StreamStates = 1 << 0, ///< Send the kart's state after every frame.
+    };
+
+    struct MessageHeader {
+        u16 type;
+        u16 flags;
+        u32 size; ///< The size of the payload following the header.
+    };
+    STATIC_ASSERT(sizeof(MessageHeader) == 0x8);
+
+    struct InputsHeader {
+        u8 course;
+        u8 character;
+        u8 vehicle;
+        u8 driftIsAuto;
+        u32 frameCount;
+    };
+    STATIC_ASSERT(sizeof(InputsHeader) == 0x8);
+
+    /// @brief The inputs of a single frame. The stick is 7-centered, as in ghost files.
+    struct InputFrame {
+        u8 buttons;
+        u8 stickX;
+        u8 stickY;
+        u8 trick;
+    };
+    STATIC_ASSERT(sizeof(InputFrame) == 0x4);
+
+    struct KartState {
+        u32 frame;
+        f32 pos[3];
+        f32 fullRot[4]; ///< Stored as x, y, z, w.
+        f32 extVel[3];
+        f32 intVel[3];
+        f32 speed;
+        f32 acceleration;
+        f32 softSpeedLimit;
+        f32 mainRot[4]; ///< Stored as x, y, z, w.
+        f32 angVel2[3];
+        f32 raceCompletion;
+        u16 checkpointId;
+        u8 jugemId;
+        u8 _pad;
+    };
+    STATIC_ASSERT(sizeof(KartState) == 0x68);
+
+    struct Result {
+        Status status;
+        u32 frameCount;
+        u32 raceTime;          ///< The final time in milliseconds, or 0 if unfinished.
+        u32 expectedTime;      ///< The ghost's final time in milliseconds, or 0 for inputs.
+        s32 desyncingTimerIdx; ///< -1 if synced, 0 for the final timer, and 1+ for lap timers.
+    };
+    STATIC_ASSERT(sizeof(Result) == 0x14);
+
+    KDaemonSystem();
+    KDaemonSystem(const KDaemonSystem &) = delete;
+    KDaemonSystem(KDaemonSystem &&) = delete;
+    ~KDaemonSystem() override;
+
+    bool serveClient();
+    bool handleRequest(const MessageHeader &header, const u8 *payload);
+
+    bool runReplay(const MessageHeader &header, const u8 *rkg, u32 size, u32 targetFrame);
+    bool runInputs(const MessageHeader &header, const u8 *payload, u32 size);
+
+    [[nodiscard]] bool loadGhost(const u8 *rkg, u32 size);
+    void startRace(Course course);
+    void warmCourse(Course course);
+    [[nodiscard]] bool calcEnd() const;
+    [[nodiscard]] s32 getDesyncingTimerIdx() const;
+
+    bool sendState(u32 frame);
+    bool sendResult(const Result &result);
+    bool sendError(const char *msg);
+    bool send(ResponseType type, const void *payload, u32 size);
+
+    static void OnInit(System::RaceConfig *config, void *arg);
+
+    /// @brief The number of course archives kept in the cache in addition to Common.szs.
+    static constexpr size_t MAX_WARM_COURSES = 4;
+
+    EGG::SceneManager *m_sceneMgr;
+    const char *m_socketPath;
+    int m_listenFd;
+    int m_clientFd;
+    u32 m_frame; ///< The number of frames calculated since the current race started.
+
+    System::RawGhostFile *m_ghost; ///< The ghost of the current job, if it replays one.
+    System::RaceConfig::Player m_player;
+    Course m_course;
+
+    std::array<Course, MAX_WARM_COURSES> m_warmCourses; ///< Ordered by most recent use.
+    size_t m_warmCourseCount;
+};
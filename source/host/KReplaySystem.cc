@@ -1,26 +1,59 @@
 #include "KReplaySystem.hh"
 
+#include "host/JobScheduler.hh"
 #include "host/Option.hh"
 #include "host/SceneCreatorDynamic.hh"
+#include "host/WorkerPool.hh"
 
 #include <abstract/File.hh>
 
+#include <game/field/KColDataCache.hh>
+#include <game/system/ArchiveCache.hh>
+#include <game/system/CourseBundle.hh>
 #include <game/system/RaceManager.hh>
+#include <game/system/ResourceManager.hh>
 
+#include <algorithm>
+#include <filesystem>
 #include <iomanip>
 
+static std::string FormatTimer(const System::Timer &timer) {
+    std::ostringstream oss;
+    oss << std::setw(2) << std::setfill('0') << timer.min << ":" << std::setw(2)
+        << std::setfill('0') << timer.sec << "." << std::setw(3) << std::setfill('0') << timer.mil;
+    return oss.str();
+}
+
+static void GetCourseArchivePath(Course course, char *buffer, size_t size) {
+    snprintf(buffer, size, "Race/Course/%s.szs", COURSE_NAMES[static_cast<s32>(course)]);
+}
+
 /// @brief Initializes the system.
+/// @details In batch mode, the scenes are initialized by the first run instead.
 void KReplaySystem::init() {
-    ASSERT(m_currentGhostFileName);
-    ASSERT(m_currentRawGhost);
-    ASSERT(m_currentGhost);
-
     auto *sceneCreator = new Host::SceneCreatorDynamic;
     m_sceneMgr = new EGG::SceneManager(sceneCreator);
 
     System::RaceConfig::RegisterInitCallback(OnInit, nullptr);
     Abstract::File::Remove("results.txt");
 
+    if (!m_batchGhosts.empty()) {
+        // Every ghost mounts the core archive, so decompress it once up front, unless it is
+        // mapped from a core pack instead
+        if (!System::ResourceManager::HasCorePack()) {
+            System::ArchiveCache::Load("Race/Common.szs");
+        }
+        Field::KColDataCache::Enable();
+        planHeats();
+
+        constexpr const char *RESULTS_HEADER = "ghost\tcourse\tstatus\ttimer\texpected\tobserved\n";
+        Abstract::File::Append("results.txt", RESULTS_HEADER, strlen(RESULTS_HEADER));
+        return;
+    }
+
+    ASSERT(m_currentGhostFileName);
+    ASSERT(m_currentGhostCount == 1);
+
     m_sceneMgr->changeScene(0);
 }
 
@@ -30,9 +63,13 @@ void KReplaySystem::calc() {
 }
 
 /// @brief Executes a run.
-/// @details A run consists of replaying a ghost.
+/// @details A run consists of replaying a ghost, or every ghost of the batch.
 /// @return Whether the run was successful or not.
 bool KReplaySystem::run() {
+    if (!m_batchGhosts.empty()) {
+        return runBatch();
+    }
+
     while (!calcEnd()) {
         calc();
     }
@@ -41,7 +78,7 @@ bool KReplaySystem::run() {
 }
 
 /// @brief Parses non-generic command line options.
-/// @details The only currently accepted option is the ghost flag.
+/// @details The currently accepted options are the ghost, batch, heat, and jobs flags.
 /// @param argc The number of arguments.
 /// @param argv The arguments.
 void KReplaySystem::parseOptions(int argc, char **argv) {
@@ -59,20 +96,30 @@ void KReplaySystem::parseOptions(int argc, char **argv) {
         switch (*flag) {
         case Host::EOption::Ghost: {
             ASSERT(i + 1 < argc);
+            loadGhost(0, argv[++i]);
+            m_currentGhostCount = 1;
+        } break;
+        case Host::EOption::Batch: {
+            ASSERT(i + 1 < argc);
+            parseBatch(argv[++i]);
+        } break;
+        case Host::EOption::Heat: {
+            ASSERT(i + 1 < argc);
 
-            m_currentGhostFileName = argv[++i];
-            m_currentRawGhost = Abstract::File::Load(m_currentGhostFileName, m_currentRawGhostSize);
-
-            if (m_currentRawGhostSize < System::RKG_HEADER_SIZE ||
-                    m_currentRawGhostSize > System::RKG_UNCOMPRESSED_INPUT_DATA_SECTION_SIZE) {
-                PANIC("File cannot be a ghost! Check the file size.");
+            unsigned long heatSize = strtoul(argv[++i], nullptr, 10);
+            if (heatSize == 0 || heatSize > System::MAX_PLAYER_COUNT) {
+                PANIC("Expected a heat size between 1 and %zu!", System::MAX_PLAYER_COUNT);
             }
 
-            // Creating the raw ghost file validates it
-            System::RawGhostFile file = System::RawGhostFile(m_currentRawGhost);
+            m_heatSize = heatSize;
+        } break;
+        case Host::EOption::Jobs: {
+            ASSERT(i + 1 < argc);
 
-            m_currentGhost = new System::GhostFile(file);
-            ASSERT(m_currentGhost);
+            m_jobCount = strtoul(argv[++i], nullptr, 10);
+            if (m_jobCount == 0) {
+                PANIC("Expected a positive number of jobs!");
+            }
         } break;
         case Host::EOption::Invalid:
         default:
@@ -100,8 +147,8 @@ KReplaySystem *KReplaySystem::Instance() {
 }
 
 KReplaySystem::KReplaySystem()
-    : m_currentGhostFileName(nullptr), m_currentGhost(nullptr), m_currentRawGhost(nullptr),
-      m_currentRawGhostSize(0) {}
+    : m_currentGhostFileName(nullptr), m_currentGhosts(),
+      m_currentGhostCount(0), m_heatSize(System::MAX_PLAYER_COUNT), m_jobCount(1) {}
 
 KReplaySystem::~KReplaySystem() {
     if (s_instance) {
@@ -110,11 +157,358 @@ KReplaySystem::~KReplaySystem() {
     }
 
     delete m_sceneMgr;
-    delete m_currentGhost;
-    delete m_currentRawGhost;
+
+    for (const auto *ghost : m_currentGhosts) {
+        delete ghost;
+    }
+}
+
+/// @brief Loads the ghost to replay for a player.
+/// @param playerIdx The player to replay the ghost with.
+/// @param path The path to the RKG file.
+void KReplaySystem::loadGhost(u8 playerIdx, const char *path) {
+    const System::GhostFile *&ghost = m_currentGhosts[playerIdx];
+    Abstract::File::MappedFile &rawGhost = m_currentRawGhosts[playerIdx];
+
+    delete ghost;
+
+    m_currentGhostFileName = path;
+    rawGhost = Abstract::File::MappedFile(path);
+
+    System::RawGhostFile file;
+    if (!file.fits(rawGhost.data(), rawGhost.size())) {
+        PANIC("File cannot be a ghost! Check the file size.");
+    }
+
+    // Creating the raw ghost file validates it
+    file = rawGhost.data();
+
+    ghost = new System::GhostFile(file);
+    ASSERT(ghost);
+}
+
+/// @brief Queues up the ghosts of a batch.
+/// @details Ghosts are sorted by course, so that each course archive is only loaded once. Within a
+/// course, longer ghosts come first, so that ghosts of similar length share a heat.
+/// @param path Either a directory, in which case every RKG file in it is queued, or a manifest
+/// listing one RKG path per line. Empty lines and lines starting with '#' are ignored.
+void KReplaySystem::parseBatch(const char *path) {
+    std::vector<std::string> paths;
+
+    // Resolve the path like the manifest and the ghosts are loaded
+    char resolved[256];
+    Abstract::File::ResolvePath(path, resolved, sizeof(resolved));
+
+    std::error_code ec;
+    if (std::filesystem::is_directory(resolved, ec)) {
+        auto iter = std::filesystem::directory_iterator(resolved, ec);
+        for (; !ec && iter != std::filesystem::directory_iterator(); iter.increment(ec)) {
+            // Keep the path as given, as each ghost's path is resolved again when it is loaded
+            if (iter->path().extension() == ".rkg") {
+                paths.push_back((std::filesystem::path(path) / iter->path().filename()).string());
+            }
+        }
+
+        if (ec) {
+            PANIC("Failed to read batch directory %s!", path);
+        }
+
+        // Directory iteration order is unspecified, so sort for reproducible results
+        std::sort(paths.begin(), paths.end());
+    } else {
+        Abstract::File::MappedFile manifest(path);
+        std::string_view view(reinterpret_cast<const char *>(manifest.data()), manifest.size());
+
+        while (!view.empty()) {
+            size_t end = std::min(view.find('\n'), view.size());
+            std::string_view line = view.substr(0, end);
+            view.remove_prefix(std::min(end + 1, view.size()));
+
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+
+            if (!line.empty() && line.front() != '#') {
+                paths.emplace_back(line);
+            }
+        }
+    }
+
+    if (paths.empty()) {
+        PANIC("No ghosts found in batch %s!", path);
+    }
+
+    m_batchGhosts.reserve(m_batchGhosts.size() + paths.size());
+    for (const auto &ghostPath : paths) {
+        addBatchGhost(ghostPath);
+    }
+
+    // Invalid ghosts are moved to the end, as they are not run
+    std::stable_sort(m_batchGhosts.begin(), m_batchGhosts.end(),
+            [](const BatchGhost &lhs, const BatchGhost &rhs) {
+                if (lhs.valid != rhs.valid) {
+                    return lhs.valid;
+                }
+
+                if (!lhs.valid || lhs.course != rhs.course) {
+                    return lhs.valid && lhs.course < rhs.course;
+                }
+
+                return lhs.frameCount > rhs.frameCount;
+            });
+}
+
+/// @brief Reads the course of a ghost and queues it up.
+/// @details Unlike the ghost flag, files which are missing, unreadable, or not ghosts are reported
+/// rather than fatal.
+/// @param path The path to the RKG file, resolved like with Abstract::File::Load.
+void KReplaySystem::addBatchGhost(const std::string &path) {
+    BatchGhost ghost;
+    ghost.path = path;
+    ghost.course = static_cast<Course>(0);
+    ghost.frameCount = 0;
+    ghost.valid = false;
+
+    char resolved[256];
+    Abstract::File::ResolvePath(path.c_str(), resolved, sizeof(resolved));
+
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(resolved, ec)) {
+        m_batchGhosts.push_back(ghost);
+        return;
+    }
+
+    // Map the file directly, as MappedFile panics if it cannot be read
+    size_t size = 0;
+    const u8 *rkg = Abstract::File::Map(resolved, size);
+    if (!rkg) {
+        m_batchGhosts.push_back(ghost);
+        return;
+    }
+
+    System::RawGhostFile file;
+    if (file.tryInit(rkg, size)) {
+        System::GhostFile parsed(file);
+        ghost.course = parsed.course();
+        ghost.frameCount = Host::JobScheduler::EstimateFrameCount(parsed.raceTimer());
+        ghost.valid = static_cast<size_t>(ghost.course) < std::size(COURSE_NAMES);
+    }
+
+    Abstract::File::Unmap(rkg, size);
+    m_batchGhosts.push_back(ghost);
+}
+
+/// @brief Splits the valid ghosts of the batch into heats.
+/// @details A heat holds consecutive valid ghosts on the same course, up to the heat size.
+void KReplaySystem::planHeats() {
+    m_heats.clear();
+
+    for (size_t i = 0; i < m_batchGhosts.size(); ++i) {
+        const BatchGhost &ghost = m_batchGhosts[i];
+        if (!ghost.valid) {
+            continue;
+        }
+
+        if (m_heats.empty() || m_heats.back().course != ghost.course ||
+                m_heats.back().ghostCount == m_heatSize) {
+            m_heats.push_back({{}, 0, ghost.course});
+        }
+
+        Heat &heat = m_heats.back();
+        heat.ghosts[heat.ghostCount++] = i;
+    }
+}
+
+/// @brief Loads the ghosts of a heat.
+/// @details When the heat is on another course than the previous one, the previous course is
+/// evicted and the new one is decompressed into the cache, so that every heat of the course mounts
+/// the same image. The scene must not be active, as the ghosts and archives are loaded into the
+/// parent heap.
+/// @param heat The heat to load.
+void KReplaySystem::startHeat(const Heat &heat) {
+    if (m_loadedCourse != heat.course) {
+        char buffer[256];
+
+        // The previous course's KColData was destroyed along with the scene
+        Field::KColDataCache::Clear();
+
+        if (m_loadedCourse) {
+            GetCourseArchivePath(*m_loadedCourse, buffer, sizeof(buffer));
+            System::ArchiveCache::Evict(buffer);
+        }
+
+        // Bundled courses are mounted from the bundle, so there is nothing to decompress
+        if (!System::CourseBundle::Contains(heat.course)) {
+            GetCourseArchivePath(heat.course, buffer, sizeof(buffer));
+            System::ArchiveCache::Load(buffer);
+        }
+        m_loadedCourse = heat.course;
+    }
+
+    m_currentGhostCount = heat.ghostCount;
+    for (u8 i = 0; i < heat.ghostCount; ++i) {
+        loadGhost(i, m_batchGhosts[heat.ghosts[i]].path.c_str());
+    }
+}
+
+/// @brief Races the ghosts of a heat to the end.
+/// @param heat The heat to race.
+/// @param result Receives the outcome of each ghost of the heat.
+void KReplaySystem::runHeat(const Heat &heat, HeatResult &result) {
+    if (m_sceneMgr->currentScene()) {
+        // TODO: Use a system heap! We currently have a dependency on the scene heap
+        m_sceneMgr->destroyScene(m_sceneMgr->currentScene());
+        startHeat(heat);
+        m_sceneMgr->createScene(2, m_sceneMgr->currentScene());
+    } else {
+        startHeat(heat);
+        m_sceneMgr->changeScene(0);
+    }
+
+    while (!calcEnd()) {
+        calc();
+    }
+
+    for (u8 i = 0; i < heat.ghostCount; ++i) {
+        result.ghosts[i] = getBatchResult(i);
+    }
+}
+
+/// @brief Replays every valid ghost of the batch in heats and writes a result line for each ghost.
+/// @details Heats are planned by Host::JobScheduler. With a single job they run in this process,
+/// and otherwise across worker processes. Results are only written once every heat has run, in the
+/// order of the batch.
+/// @return Whether every ghost of the batch synced.
+bool KReplaySystem::runBatch() {
+    Host::JobScheduler scheduler;
+    for (const auto &heat : m_heats) {
+        // Each kart costs about the same per frame, on top of the course and its objects
+        u64 frameCount = m_batchGhosts[heat.ghosts[0]].frameCount;
+        scheduler.add(heat.course, 0, frameCount * (heat.ghostCount + 1));
+    }
+
+    scheduler.plan(m_jobCount);
+
+    std::vector<HeatResult> heatResults(m_heats.size());
+
+    if (m_jobCount > 1 && !m_heats.empty()) {
+        scheduler.reportPlan();
+
+        Host::WorkerPool pool(m_heats.size(), sizeof(HeatResult));
+        pool.run(scheduler.queues(), RunWorkerJob, nullptr);
+
+        for (size_t i = 0; i < m_heats.size(); ++i) {
+            if (pool.isDone(i)) {
+                heatResults[i] = *reinterpret_cast<const HeatResult *>(pool.record(i));
+                continue;
+            }
+
+            for (auto &ghostResult : heatResults[i].ghosts) {
+                ghostResult.status = BatchStatus::Crashed;
+            }
+        }
+
+        scheduler.reportUtilization(pool);
+    } else {
+        for (u32 idx : scheduler.queues()[0]) {
+            runHeat(m_heats[idx], heatResults[idx]);
+        }
+    }
+
+    std::vector<BatchResult> results(m_batchGhosts.size());
+    for (auto &result : results) {
+        result.status = BatchStatus::Invalid;
+    }
+
+    for (size_t i = 0; i < m_heats.size(); ++i) {
+        const Heat &heat = m_heats[i];
+        for (u8 j = 0; j < heat.ghostCount; ++j) {
+            results[heat.ghosts[j]] = heatResults[i].ghosts[j];
+        }
+    }
+
+    bool success = true;
+    for (size_t i = 0; i < m_batchGhosts.size(); ++i) {
+        success &= writeBatchResult(m_batchGhosts[i], results[i]);
+    }
+
+    return success;
+}
+
+/// @brief Compares a player's timers against its ghost at the end of a heat.
+/// @param playerIdx The player the ghost was replayed with.
+/// @return The outcome of the ghost.
+KReplaySystem::BatchResult KReplaySystem::getBatchResult(u8 playerIdx) const {
+    BatchResult result;
+    result.status = BatchStatus::Sync;
+    result.timerIdx = -1;
+    result.expected = m_currentGhosts[playerIdx]->raceTimer();
+    result.observed = result.expected;
+
+    if (!System::RaceManager::Instance()->player(playerIdx).isFinished()) {
+        result.status = BatchStatus::Dnf;
+        return result;
+    }
+
+    result.timerIdx = getDesyncingTimerIdx(playerIdx);
+    if (result.timerIdx != -1) {
+        const auto [correct, incorrect] = getDesyncingTimer(result.timerIdx, playerIdx);
+        result.status = BatchStatus::Desync;
+        result.expected = correct;
+        result.observed = incorrect;
+    }
+
+    return result;
+}
+
+/// @brief Appends the outcome of a batch ghost to the results file.
+/// @details Each line holds the tab-separated ghost path, course, status (sync, desync, dnf,
+/// invalid, or crashed), desyncing timer (final or lapN), expected time, and observed time. Unused
+/// fields are written as '-'.
+/// @param ghost The ghost that was replayed.
+/// @param result The outcome of the ghost.
+/// @return Whether the ghost synced.
+bool KReplaySystem::writeBatchResult(const BatchGhost &ghost, const BatchResult &result) const {
+    std::string status;
+    std::string timer = "-";
+    std::string expected = "-";
+    std::string observed = "-";
+
+    switch (result.status) {
+    case BatchStatus::Sync:
+        status = "sync";
+        expected = FormatTimer(result.expected);
+        observed = expected;
+        break;
+    case BatchStatus::Desync:
+        status = "desync";
+        timer = result.timerIdx == 0 ? "final" : "lap" + std::to_string(result.timerIdx);
+        expected = FormatTimer(result.expected);
+        observed = FormatTimer(result.observed);
+        break;
+    case BatchStatus::Dnf:
+        status = "dnf";
+        expected = FormatTimer(result.expected);
+        break;
+    case BatchStatus::Invalid:
+        status = "invalid";
+        break;
+    case BatchStatus::Crashed:
+    default:
+        status = "crashed";
+        break;
+    }
+
+    const char *course = ghost.valid ? COURSE_NAMES[static_cast<s32>(ghost.course)] : "-";
+    std::string line = ghost.path + "\t" + course + "\t" + status + "\t" + timer + "\t" + expected +
+            "\t" + observed + "\n";
+    Abstract::File::Append("results.txt", line.c_str(), line.size());
+
+    return result.status == BatchStatus::Sync;
 }
 
 /// @brief Determines whether or not the ghost simulation should end.
+/// @details The simulation ends once every ghost has finished, or once the race runs too long.
 /// @return Whether the ghost should end or not.
 bool KReplaySystem::calcEnd() const {
     constexpr u16 MAX_MINUTE_COUNT = 10;
@@ -142,32 +536,24 @@ void KReplaySystem::reportFail(const std::string &msg) const {
 /// @brief Determines whether the simulation was a success or not.
 /// @return Whether the simulation was a success or not.
 bool KReplaySystem::success() const {
-    auto format = [](const System::Timer &timer) {
-        std::ostringstream oss;
-        oss << std::setw(2) << std::setfill('0') << timer.min << ":" << std::setw(2)
-            << std::setfill('0') << timer.sec << "." << std::setw(3) << std::setfill('0')
-            << timer.mil;
-        return oss.str();
-    };
-
     const auto *raceManager = System::RaceManager::Instance();
     if (raceManager->stage() != System::RaceManager::Stage::FinishGlobal) {
         reportFail("Race didn't finish");
         return false;
     }
 
-    s32 desyncingTimerIdx = getDesyncingTimerIdx();
+    s32 desyncingTimerIdx = getDesyncingTimerIdx(0);
     if (desyncingTimerIdx != -1) {
         std::string msg;
 
-        const auto [correct, incorrect] = getDesyncingTimer(desyncingTimerIdx);
+        const auto [correct, incorrect] = getDesyncingTimer(desyncingTimerIdx, 0);
         if (desyncingTimerIdx == 0) {
             msg = "Final timer desync!";
         } else {
             msg = "Lap " + std::to_string(desyncingTimerIdx) + " timer desync!";
         }
 
-        msg += " Expected " + format(correct) + ", got " + format(incorrect);
+        msg += " Expected " + FormatTimer(correct) + ", got " + FormatTimer(incorrect);
         reportFail(msg);
         return false;
     }
@@ -175,16 +561,18 @@ bool KReplaySystem::success() const {
     return true;
 }
 
-/// @brief Finds the desyncing timer index, if one exists.
+/// @brief Finds the desyncing timer index of a player, if one exists.
+/// @param playerIdx The player whose timers to compare against its ghost.
 /// @return -1 if there's no desync, 0 if the final timer desyncs, and 1+ if a lap timer desyncs.
-s32 KReplaySystem::getDesyncingTimerIdx() const {
-    const auto &player = System::RaceManager::Instance()->player();
-    if (m_currentGhost->raceTimer() != player.raceTimer()) {
+s32 KReplaySystem::getDesyncingTimerIdx(u8 playerIdx) const {
+    const auto *ghost = m_currentGhosts[playerIdx];
+    const auto &player = System::RaceManager::Instance()->player(playerIdx);
+    if (ghost->raceTimer() != player.raceTimer()) {
         return 0;
     }
 
     for (size_t i = 0; i < 3; ++i) {
-        if (m_currentGhost->lapTimer(i) != player.getLapSplit(i + 1)) {
+        if (ghost->lapTimer(i) != player.getLapSplit(i + 1)) {
             return i + 1;
         }
     }
@@ -194,19 +582,23 @@ s32 KReplaySystem::getDesyncingTimerIdx() const {
 
 /// @brief Gets the desyncing timer according to the index.
 /// @param i Index to the desyncing timer. Cannot be -1.
+/// @param playerIdx The player whose timers desynced.
 /// @return The pair of timers. The first is the correct one, and the second is the incorrect one.
-KReplaySystem::DesyncingTimerPair KReplaySystem::getDesyncingTimer(s32 i) const {
+KReplaySystem::DesyncingTimerPair KReplaySystem::getDesyncingTimer(s32 i, u8 playerIdx) const {
     auto cond = i <=> 0;
     ASSERT(cond != std::strong_ordering::less);
 
+    const auto *ghost = m_currentGhosts[playerIdx];
+    const auto &player = System::RaceManager::Instance()->player(playerIdx);
+
     if (cond == std::strong_ordering::equal) {
-        const auto &correct = m_currentGhost->raceTimer();
-        const auto &incorrect = System::RaceManager::Instance()->player().raceTimer();
+        const auto &correct = ghost->raceTimer();
+        const auto &incorrect = player.raceTimer();
         ASSERT(correct != incorrect);
         return DesyncingTimerPair(correct, incorrect);
     } else if (cond == std::strong_ordering::greater) {
-        const auto &correct = m_currentGhost->lapTimer(i - 1);
-        const auto &incorrect = System::RaceManager::Instance()->player().lapTimer(i - 1);
+        const auto &correct = ghost->lapTimer(i - 1);
+        const auto &incorrect = player.lapTimer(i - 1);
         ASSERT(correct != incorrect);
         return DesyncingTimerPair(correct, incorrect);
     }
@@ -219,6 +611,23 @@ KReplaySystem::DesyncingTimerPair KReplaySystem::getDesyncingTimer(s32 i) const
 /// @param config The race configuration instance.
 /// @param arg Unused optional argument.
 void KReplaySystem::OnInit(System::RaceConfig *config, void * /* arg */) {
-    config->setGhost(Instance()->m_currentRawGhost);
-    config->raceScenario().players[0].type = System::RaceConfig::Player::Type::Ghost;
+    auto *system = Instance();
+    auto &scenario = config->raceScenario();
+    scenario.playerCount = system->m_currentGhostCount;
+
+    for (u8 i = 0; i < system->m_currentGhostCount; ++i) {
+        config->setGhost(i, system->m_currentRawGhosts[i].data());
+        scenario.players[i].type = System::RaceConfig::Player::Type::Ghost;
+    }
+}
+
+/// @brief Runs a single heat inside of a worker process.
+/// @details Each worker initializes the scenes on its first heat, and afterwards recreates the race
+/// scene for each heat.
+/// @param job The index of the heat.
+/// @param record The heat's HeatResult.
+/// @param arg Unused optional argument.
+void KReplaySystem::RunWorkerJob(u32 job, void *record, void * /* arg */) {
+    auto *system = Instance();
+    system->runHeat(system->m_heats[job], *reinterpret_cast<HeatResult *>(record));
 }
@@ -4,7 +4,17 @@
 
 #include <game/system/RaceConfig.hh>
 
+#include <abstract/File.hh>
+
+#include <optional>
+#include <vector>
+
 /// @brief Kinoko system designed to execute replays.
+/// @details In batch mode, consecutive ghosts on the same course are raced together in heats of up
+/// to System::MAX_PLAYER_COUNT ghosts, one per player. Time trial ghosts never touch each other, so
+/// each ghost's result matches replaying it alone, while the course and its objects are only
+/// loaded and simulated once per heat. Ghosts of similar length share a heat, since a heat lasts
+/// as long as its longest ghost. Heats are dispatched across workers by Host::JobScheduler.
 class KReplaySystem : public KSystem {
 public:
     void init() override;
@@ -19,24 +29,80 @@ public:
 private:
     typedef std::pair<const System::Timer &, const System::Timer &> DesyncingTimerPair;
 
+    /// @brief A ghost queued in batch mode.
+    struct BatchGhost {
+        std::string path;
+        Course course;
+        u64 frameCount; ///< The estimated number of frames until the ghost finishes.
+        bool valid;     ///< Whether the file is a ghost for a supported course.
+    };
+
+    /// @brief Ghosts on the same course which are raced together.
+    struct Heat {
+        std::array<size_t, System::MAX_PLAYER_COUNT> ghosts; ///< Indices of the batch ghosts.
+        u8 ghostCount;
+        Course course;
+    };
+
+    enum class BatchStatus : u8 {
+        Sync,
+        Desync,
+        Dnf,
+        Invalid,
+        Crashed, ///< The ghost's worker exited before finishing its heat.
+    };
+
+    /// @brief The outcome of a batch ghost.
+    struct BatchResult {
+        BatchStatus status;
+        s8 timerIdx; ///< The desyncing timer, as returned by getDesyncingTimerIdx.
+        System::Timer expected;
+        System::Timer observed;
+    };
+
+    /// @brief The outcome of a heat run by a worker process.
+    struct HeatResult {
+        std::array<BatchResult, System::MAX_PLAYER_COUNT> ghosts;
+    };
+
     KReplaySystem();
     KReplaySystem(const KReplaySystem &) = delete;
     KReplaySystem(KReplaySystem &&) = delete;
     ~KReplaySystem() override;
 
+    void loadGhost(u8 playerIdx, const char *path);
+    void parseBatch(const char *path);
+    void addBatchGhost(const std::string &path);
+    void planHeats();
+    void startHeat(const Heat &heat);
+    void runHeat(const Heat &heat, HeatResult &result);
+    bool runBatch();
+    BatchResult getBatchResult(u8 playerIdx) const;
+    bool writeBatchResult(const BatchGhost &ghost, const BatchResult &result) const;
+
     bool calcEnd() const;
     void reportFail(const std::string &msg) const;
 
     bool success() const;
-    s32 getDesyncingTimerIdx() const;
-    DesyncingTimerPair getDesyncingTimer(s32 i) const;
+    s32 getDesyncingTimerIdx(u8 playerIdx) const;
+    DesyncingTimerPair getDesyncingTimer(s32 i, u8 playerIdx) const;
 
     static void OnInit(System::RaceConfig *config, void *arg);
+    static void RunWorkerJob(u32 job, void *record, void *arg);
 
     EGG::SceneManager *m_sceneMgr;
 
     const char *m_currentGhostFileName;
-    const System::GhostFile *m_currentGhost;
-    const u8 *m_currentRawGhost;
-    size_t m_currentRawGhostSize;
+
+    /// @brief The ghost of each player of the current race.
+    std::array<const System::GhostFile *, System::MAX_PLAYER_COUNT> m_currentGhosts;
+    std::array<Abstract::File::MappedFile, System::MAX_PLAYER_COUNT> m_currentRawGhosts;
+    u8 m_currentGhostCount;
+
+    /// @brief Sorted such that ghosts are grouped by course, and then by descending frame count.
+    std::vector<BatchGhost> m_batchGhosts;
+    std::vector<Heat> m_heats;
+    std::optional<Course> m_loadedCourse; ///< The course whose archive is in the cache.
+    u8 m_heatSize;                        ///< The number of ghosts to race together at most.
+    u32 m_jobCount;                       ///< The number of worker processes to run heats on.
 };
@@ -1,10 +1,16 @@
 #include "KTestSystem.hh"
 
+#include "host/JobScheduler.hh"
 #include "host/Option.hh"
 #include "host/SceneCreatorDynamic.hh"
+#include "host/WorkerPool.hh"
 
 #include <game/kart/KartObjectManager.hh>
+#include <game/kart/KartSub.hh>
+#include <game/system/ArchiveCache.hh>
+#include <game/system/GhostFile.hh>
 #include <game/system/RaceManager.hh>
+#include <game/system/ResourceManager.hh>
 
 #include <abstract/File.hh>
 
@@ -30,7 +36,8 @@ struct TestHeader {
 
 /// @brief Initializes the system.
 /// @details This reads over the KRKG and generates the list of test cases,
-/// before starting the first test case and initializing the race scene.
+/// before starting the first test case and initializing the race scene. When running on multiple
+/// workers, each worker initializes its own scenes instead.
 void KTestSystem::init() {
     constexpr u32 TEST_HEADER_SIGNATURE = 0x54535448; // TSTH
     constexpr u32 TEST_FOOTER_SIGNATURE = 0x54535446; // TSTF
@@ -52,6 +59,8 @@ void KTestSystem::init() {
                 testMajorVer, testMinorVer, SUITE_MAJOR_VER, SUITE_MAX_MINOR_VER);
     }
 
+    m_testCases.reserve(numTestCases);
+
     for (u16 i = 0; i < numTestCases; ++i) {
         // Validate alignment
         if (m_stream.read_u32() != TEST_HEADER_SIGNATURE) {
@@ -90,11 +99,42 @@ void KTestSystem::init() {
             PANIC("Unexpected bytes in test case");
         }
 
-        m_testCases.push(testCase);
+        m_testCases.push_back(testCase);
+    }
+
+    // Every test case mounts the core archive, so decompress it once up front, unless it is
+    // mapped from a core pack instead
+    if (!System::ResourceManager::HasCorePack()) {
+        System::ArchiveCache::Load("Race/Common.szs");
+    }
+
+    if (m_traceDir) {
+        if (m_jobCount > 1) {
+            WARN("Tracing and bisecting run on a single job!");
+            m_jobCount = 1;
+        }
+
+        m_trace = new (Kinoko::SystemAllocator<Host::StateTrace>().allocate(1)) Host::StateTrace;
+
+        if (m_bisect) {
+            constexpr size_t REWIND_BUDGET = 512 * 1024 * 1024;
+            constexpr u32 KEYFRAME_INTERVAL = SNAPSHOT_INTERVAL * 30;
+
+            m_rewindBuffer = new (Kinoko::SystemAllocator<Kinoko::RewindBuffer>().allocate(1))
+                    Kinoko::RewindBuffer(REWIND_BUDGET, KEYFRAME_INTERVAL);
+        }
+    }
+
+    m_warmState = new (Kinoko::SystemAllocator<Kinoko::SaveState>().allocate(1))
+            Kinoko::SaveState;
+
+    if (m_jobCount > 1) {
+        return;
     }
 
     startNextTestCase();
     m_sceneMgr->changeScene(0);
+    saveWarmState();
 }
 
 /// @brief Executes a frame.
@@ -106,26 +146,28 @@ void KTestSystem::calc() {
 /// @details A run consists of iterating over all tests.
 /// @return Whether the run was successful or not.
 bool KTestSystem::run() {
+    if (m_jobCount > 1) {
+        return runWorkers();
+    }
+
     bool success = true;
 
     while (true) {
         success &= runTest();
+        writeTestOutput(getCurrentTestCase(), m_sync, m_frameCount);
 
         if (!popTestCase()) {
             break;
         }
 
-        // TODO: Use a system heap! We currently have a dependency on the scene heap
-        m_sceneMgr->destroyScene(m_sceneMgr->currentScene());
-        startNextTestCase();
-        m_sceneMgr->createScene(2, m_sceneMgr->currentScene());
+        restartRace();
     }
 
     return success;
 }
 
 /// @brief Parses non-generic command line options.
-/// @details The only currently accepted option is the suite flag.
+/// @details The currently accepted options are the suite, jobs, trace, and bisect flags.
 /// @param argc The number of arguments.
 /// @param argv The arguments.
 void KTestSystem::parseOptions(int argc, char **argv) {
@@ -144,16 +186,31 @@ void KTestSystem::parseOptions(int argc, char **argv) {
         case Host::EOption::Suite: {
             ASSERT(i + 1 < argc);
 
-            size_t size;
-            u8 *data = Abstract::File::Load(argv[++i], size);
-
-            if (size == 0) {
+            *m_streamFile = Abstract::File::MappedFile(argv[++i]);
+            if (m_streamFile->size() == 0) {
                 PANIC("Failed to load suite data!");
             }
 
-            m_stream = EGG::RamStream(data, size);
+            // The stream is only ever read from, so it can read from the view directly
+            m_stream = EGG::RamStream(const_cast<u8 *>(m_streamFile->data()),
+                    m_streamFile->size());
             m_stream.setEndian(std::endian::big);
         } break;
+        case Host::EOption::Jobs: {
+            ASSERT(i + 1 < argc);
+
+            m_jobCount = strtoul(argv[++i], nullptr, 10);
+            if (m_jobCount == 0) {
+                PANIC("Expected a positive number of jobs!");
+            }
+        } break;
+        case Host::EOption::Trace:
+        case Host::EOption::Bisect: {
+            ASSERT(i + 1 < argc);
+
+            m_traceDir = argv[++i];
+            m_bisect = *flag == Host::EOption::Bisect;
+        } break;
         case Host::EOption::Invalid:
         default:
             PANIC("Invalid flag!");
@@ -179,27 +236,50 @@ KTestSystem *KTestSystem::Instance() {
     return static_cast<KTestSystem *>(s_instance);
 }
 
-KTestSystem::KTestSystem() = default;
+KTestSystem::KTestSystem()
+    : m_currentTestCase(0), m_jobCount(1), m_traceDir(nullptr), m_bisect(false),
+      m_traceLoaded(false), m_trace(nullptr), m_rewindBuffer(nullptr), m_warmState(nullptr) {
+    m_streamFile = new (Kinoko::SystemAllocator<Abstract::File::MappedFile>().allocate(1))
+            Abstract::File::MappedFile;
+}
 
 KTestSystem::~KTestSystem() {
     if (s_instance) {
         s_instance = nullptr;
         WARN("KTestSystem instance not explicitly handled!");
     }
+
+    if (m_trace) {
+        m_trace->~StateTrace();
+        Kinoko::SystemAllocator<Host::StateTrace>().deallocate(m_trace, 1);
+    }
+
+    if (m_rewindBuffer) {
+        m_rewindBuffer->~RewindBuffer();
+        Kinoko::SystemAllocator<Kinoko::RewindBuffer>().deallocate(m_rewindBuffer, 1);
+    }
+
+    if (m_warmState) {
+        m_warmState->~SaveState();
+        Kinoko::SystemAllocator<Kinoko::SaveState>().deallocate(m_warmState, 1);
+    }
+
+    m_streamFile->~MappedFile();
+    Kinoko::SystemAllocator<Abstract::File::MappedFile>().deallocate(m_streamFile, 1);
 }
 
 /// @brief Starts the next test case.
 void KTestSystem::startNextTestCase() {
     constexpr u32 KRKG_SIGNATURE = 0x4b524b47; // KRKG
 
-    size_t size;
-    u8 *krkg = Abstract::File::Load(getCurrentTestCase().krkgPath.data(), size);
-    m_stream = EGG::RamStream(krkg, static_cast<u32>(size));
+    *m_streamFile = Abstract::File::MappedFile(getCurrentTestCase().krkgPath.data());
+    const u8 *krkg = m_streamFile->data();
+    m_stream = EGG::RamStream(const_cast<u8 *>(krkg), static_cast<u32>(m_streamFile->size()));
     m_currentFrame = -1;
     m_sync = true;
 
     // Initialize endianness for the RAM stream
-    u16 mark = *reinterpret_cast<u16 *>(krkg + offsetof(TestHeader, byteOrderMark));
+    u16 mark = *reinterpret_cast<const u16 *>(krkg + offsetof(TestHeader, byteOrderMark));
     std::endian endian = parse<u16>(mark) == 0xfeff ? std::endian::big : std::endian::little;
     m_stream.setEndian(endian);
 
@@ -212,14 +292,59 @@ void KTestSystem::startNextTestCase() {
     ASSERT(m_stream.read_u32() == m_stream.index());
 }
 
-/// @brief Pops the current test case and frees the KRKG buffer.
-/// @return Whether the queue still has elements remaining.
+/// @brief Advances past the current test case and unmaps its KRKG.
+/// @return Whether there are test cases remaining.
 bool KTestSystem::popTestCase() {
-    ASSERT(m_testCases.size() > 0);
-    m_testCases.pop();
-    delete[] m_stream.data();
+    ASSERT(m_currentTestCase < m_testCases.size());
+    ++m_currentTestCase;
+    m_streamFile->reset();
+
+    return m_currentTestCase < m_testCases.size();
+}
+
+/// @brief Sets up the race scene for the current test case, whose KRKG must not be loaded yet.
+/// @details If the race scene was set up for the same course, character, vehicle and drift type,
+/// the snapshot taken right after its engines were initialized is restored, and only the ghost's
+/// inputs are replaced. This skips remounting the archives and reconstructing every object.
+/// Otherwise, the race scene is recreated and a new snapshot is taken.
+void KTestSystem::restartRace() {
+    // The ghost must outlive restoring the snapshot, so it is kept on the stack
+    Abstract::File::MappedFile rkg(getCurrentTestCase().rkgPath.data());
+    System::RawGhostFile raw(rkg.data());
+
+    if (!m_warmState->isValid() || !isWarmMatch(System::GhostFile(raw))) {
+        // TODO: Use a system heap! We currently have a dependency on the scene heap
+        m_sceneMgr->destroyScene(m_sceneMgr->currentScene());
+        startNextTestCase();
+        m_sceneMgr->createScene(2, m_sceneMgr->currentScene());
+        saveWarmState();
+        return;
+    }
+
+    // This system is restored too, so it would return to the test case the snapshot was taken on
+    u16 testCase = m_currentTestCase;
+    Kinoko::EngineContext::Current()->loadState(*m_warmState);
+    m_currentTestCase = testCase;
+    startNextTestCase();
+
+    auto *config = System::RaceConfig::Instance();
+    config->setGhost(0, raw.buffer());
+    config->initGhost(0);
+}
+
+/// @brief Takes the snapshot which restartRace restores, once the race scene is initialized.
+void KTestSystem::saveWarmState() {
+    Kinoko::EngineContext::Current()->saveState(*m_warmState);
+}
 
-    return !m_testCases.empty();
+/// @brief Whether the race scene was set up for the same parameters as the ghost.
+/// @details Aside from the ghost's inputs, nothing the scene constructs depends on the ghost.
+bool KTestSystem::isWarmMatch(const System::GhostFile &ghost) const {
+    const auto &scenario = System::RaceConfig::Instance()->raceScenario();
+    const auto &player = scenario.players[0];
+
+    return scenario.course == ghost.course() && player.character == ghost.character() &&
+            player.vehicle == ghost.vehicle() && player.driftIsAuto == ghost.driftIsAuto();
 }
 
 /// @brief Checks one frame in the test.
@@ -240,63 +365,80 @@ bool KTestSystem::calcTest() {
 }
 
 /// @brief Finds the test data of the current frame.
+/// @details Every field of a frame is a float, except for those following the race completion.
+/// The floats are therefore read and byteswapped in bulk.
 /// @return The test data of the current frame.
 KTestSystem::TestData KTestSystem::findCurrentFrameEntry() {
-    EGG::Vector3f pos;
-    EGG::Quatf fullRot;
-    EGG::Vector3f extVel;
-    EGG::Vector3f intVel;
-    f32 speed = 0.0f;
-    f32 acceleration = 0.0f;
-    f32 softSpeedLimit = 0.0f;
-    EGG::Quatf mainRot;
-    EGG::Vector3f angVel2;
-    f32 raceCompletion = 0.0f;
-    u16 checkpointId = 0;
-    u8 jugemId = 0;
-
-    pos.read(m_stream);
-    fullRot.read(m_stream);
-
+    // Position and full rotation, followed by the floats added in each version
+    size_t floatCount = 7;
     if (m_versionMinor >= Changelog::AddedExtVel) {
-        extVel.read(m_stream);
+        floatCount += 3;
     }
-
     if (m_versionMinor >= Changelog::AddedIntVel) {
-        intVel.read(m_stream);
+        floatCount += 3;
+    }
+    if (m_versionMinor >= Changelog::AddedSpeed) {
+        floatCount += 3;
+    }
+    if (m_versionMinor >= Changelog::AddedRotation) {
+        floatCount += 7;
+    }
+    if (m_versionMinor >= Changelog::AddedCheckpoints) {
+        floatCount += 1;
     }
 
+    std::array<f32, 24> floats;
+    m_stream.read_array(std::span<f32>(floats.data(), floatCount));
+
+    size_t idx = 0;
+    auto readF32 = [&]() { return floats[idx++]; };
+    auto readVec3 = [&]() {
+        EGG::Vector3f vec;
+        vec.x = readF32();
+        vec.y = readF32();
+        vec.z = readF32();
+        return vec;
+    };
+    auto readQuat = [&]() {
+        EGG::Quatf quat;
+        quat.v = readVec3();
+        quat.w = readF32();
+        return quat;
+    };
+
+    TestData data;
+    data.pos = readVec3();
+    data.fullRot = readQuat();
+    data.extVel = m_versionMinor >= Changelog::AddedExtVel ? readVec3() : EGG::Vector3f();
+    data.intVel = m_versionMinor >= Changelog::AddedIntVel ? readVec3() : EGG::Vector3f();
+    data.speed = 0.0f;
+    data.acceleration = 0.0f;
+    data.softSpeedLimit = 0.0f;
+    data.mainRot = EGG::Quatf();
+    data.angVel2 = EGG::Vector3f();
+    data.raceCompletion = 0.0f;
+    data.checkpointId = 0;
+    data.jugemId = 0;
+
     if (m_versionMinor >= Changelog::AddedSpeed) {
-        speed = m_stream.read_f32();
-        acceleration = m_stream.read_f32();
-        softSpeedLimit = m_stream.read_f32();
+        data.speed = readF32();
+        data.acceleration = readF32();
+        data.softSpeedLimit = readF32();
     }
 
     if (m_versionMinor >= Changelog::AddedRotation) {
-        mainRot.read(m_stream);
-        angVel2.read(m_stream);
+        data.mainRot = readQuat();
+        data.angVel2 = readVec3();
     }
 
     if (m_versionMinor >= Changelog::AddedCheckpoints) {
-        raceCompletion = m_stream.read_f32();
-        checkpointId = m_stream.read_u16();
-        jugemId = m_stream.read_u8();
+        data.raceCompletion = readF32();
+        data.checkpointId = m_stream.read_u16();
+        data.jugemId = m_stream.read_u8();
         m_stream.skip(1);
     }
 
-    TestData data;
-    data.pos = pos;
-    data.fullRot = fullRot;
-    data.extVel = extVel;
-    data.intVel = intVel;
-    data.speed = speed;
-    data.acceleration = acceleration;
-    data.softSpeedLimit = softSpeedLimit;
-    data.mainRot = mainRot;
-    data.angVel2 = angVel2;
-    data.raceCompletion = raceCompletion;
-    data.checkpointId = checkpointId;
-    data.jugemId = jugemId;
+    ASSERT(idx == floatCount);
     return data;
 }
 
@@ -314,7 +456,7 @@ void KTestSystem::testFrame(const TestData &data) {
     const auto &mainRot = object->mainRot();
     const auto &angVel2 = object->angVel2();
 
-    const auto &player = System::RaceManager::Instance()->player();
+    const auto &player = System::RaceManager::Instance()->player(0);
     f32 raceCompletion = player.raceCompletion();
     u16 checkpointId = player.checkpointId();
     u8 jugemId = player.jugemId();
@@ -347,43 +489,238 @@ void KTestSystem::testFrame(const TestData &data) {
 }
 
 /// @brief Runs a single test case, and ends when the test is finished or when a desync is found.
-/// @details This will also accumulate results in results.txt.
 /// @return Whether the run synchronized or desynchronized.
 bool KTestSystem::runTest() {
+    if (m_trace) {
+        beginTrace();
+    }
+
     while (calcTest()) {
+        if (m_trace) {
+            calcTrace();
+        }
+
         calc();
     }
 
-    writeTestOutput();
+    if (m_trace) {
+        endTrace();
+    }
+
     return m_sync;
 }
 
-/// @brief Writes details about the current test to file.
+/// @brief Runs all test cases across forked worker processes.
+/// @details The workers inherit the decompressed core archive from this process. Results are only
+/// written once all workers have exited, so results.txt keeps the order of the suite. Test cases
+/// are grouped by course and setup and dispatched longest-first, see Host::JobScheduler.
+/// @return Whether all test cases synchronized.
+bool KTestSystem::runWorkers() {
+    u16 testCaseCount = m_testCases.size();
+    Host::JobScheduler scheduler;
+
+    for (const auto &testCase : m_testCases) {
+        System::RawGhostFile raw(Abstract::File::MappedFile(testCase.rkgPath.data()).data());
+
+        // Test cases which share a setup restart from the same snapshot
+        System::GhostFile ghost(raw);
+        u32 setup = static_cast<u32>(ghost.character()) << 16 |
+                static_cast<u32>(ghost.vehicle()) << 8 | static_cast<u32>(ghost.driftIsAuto());
+
+        // The target frame is exact, so there is no need to estimate it from the race time
+        scheduler.add(ghost.course(), setup, testCase.targetFrame + 1);
+    }
+
+    scheduler.plan(m_jobCount);
+    scheduler.reportPlan();
+
+    Host::WorkerPool pool(testCaseCount, sizeof(TestResult));
+    pool.run(scheduler.queues(), RunWorkerJob, nullptr);
+
+    bool success = true;
+
+    for (u16 i = 0; i < testCaseCount; ++i) {
+        const TestCase &testCase = m_testCases[i];
+
+        if (!pool.isDone(i)) {
+            REPORT("Test Case Failed: %s [Worker exited unexpectedly]", testCase.name.c_str());
+            writeTestOutput(testCase, false, 0);
+            success = false;
+            continue;
+        }
+
+        const auto *result = reinterpret_cast<const TestResult *>(pool.record(i));
+        writeTestOutput(testCase, result->sync, result->frameCount);
+        success &= result->sync;
+    }
+
+    scheduler.reportUtilization(pool);
+
+    return success;
+}
+
+/// @brief Starts recording the current test case's trace, or loads it to bisect against.
+void KTestSystem::beginTrace() {
+    if (!m_bisect) {
+        m_trace->begin(Host::StateTrace::Mode::Record);
+        Kart::KartSub::RegisterStageCallback(OnKartStage, m_trace);
+        return;
+    }
+
+    std::string path = getTracePath();
+    m_traceLoaded = m_trace->load(path.c_str());
+    if (!m_traceLoaded) {
+        WARN("Cannot bisect %s, as %s is not a valid trace!", getCurrentTestCase().name.c_str(),
+                path.c_str());
+    }
+
+    m_trace->begin(Host::StateTrace::Mode::Compare);
+    m_rewindBuffer->clear();
+}
+
+/// @brief Records the state at the start of the current frame, or snapshots it when bisecting.
+void KTestSystem::calcTrace() {
+    if (!m_bisect) {
+        m_trace->calcFrame(m_currentFrame);
+    } else if (m_traceLoaded && m_currentFrame % SNAPSHOT_INTERVAL == 0) {
+        m_rewindBuffer->push(*Kinoko::EngineContext::Current(), m_currentFrame);
+    }
+}
+
+/// @brief Writes the current test case's trace, or bisects it if it desynced.
+void KTestSystem::endTrace() {
+    if (!m_bisect) {
+        Kart::KartSub::RegisterStageCallback(nullptr, nullptr);
+
+        std::string path = getTracePath();
+        if (!m_trace->save(path.c_str())) {
+            WARN("Failed to write trace %s!", path.c_str());
+        }
+    } else if (!m_sync && m_traceLoaded) {
+        bisect(m_currentFrame);
+    }
+}
+
+/// @brief Finds the first stage at which the current test case diverged from its trace.
+/// @details Rewinds to the latest snapshot whose state still matches the trace, then replays each
+/// frame up to the desync while comparing every stage against the trace.
+/// @param desyncFrame The frame at which the test data first mismatched.
+void KTestSystem::bisect(u16 desyncFrame) {
+    auto *context = Kinoko::EngineContext::Current();
+    u32 endFrame = std::min<u32>(desyncFrame, m_trace->frameCount());
+    if (endFrame == 0) {
+        REPORT("Bisect: No frames precede the desync");
+        return;
+    }
+
+    u32 frame = endFrame - 1;
+    bool matched = false;
+
+    while (m_rewindBuffer->rewind(*context, frame)) {
+        m_trace->begin(Host::StateTrace::Mode::Compare);
+        m_trace->calcFrame(frame);
+        if (!m_trace->hasMismatch()) {
+            matched = true;
+            break;
+        }
+
+        if (frame == 0) {
+            break;
+        }
+
+        --frame;
+    }
+
+    if (matched) {
+        REPORT("Bisect: Replaying from frame %u", frame);
+        Kart::KartSub::RegisterStageCallback(OnKartStage, m_trace);
+
+        for (; frame < endFrame && !m_trace->hasMismatch(); ++frame) {
+            m_trace->calcFrame(frame);
+            calc();
+        }
+
+        Kart::KartSub::RegisterStageCallback(nullptr, nullptr);
+    } else {
+        REPORT("Bisect: The earliest snapshot already diverged from the trace");
+    }
+
+    m_trace->report();
+
+    // Rewinding restored this system's state from the snapshot, including the sync flag
+    m_sync = false;
+}
+
+/// @brief Gets the path of the current test case's trace within the trace directory.
+std::string KTestSystem::getTracePath() const {
+    std::string name = getCurrentTestCase().name;
+    std::replace(name.begin(), name.end(), '/', '_');
+
+    return std::string(m_traceDir) + "/" + name + ".ktrc";
+}
+
+/// @brief Writes details about a test to file.
 /// @details This is designed to be cumulative across multiple tests.
-void KTestSystem::writeTestOutput() const {
-    std::string outStr(getCurrentTestCase().name.data());
-    outStr += "\n" + std::string(m_sync ? "1" : "0") + "\n";
-    outStr += std::to_string(getCurrentTestCase().targetFrame) + "\n";
-    outStr += std::to_string(m_frameCount) + "\n";
+/// @param testCase The test case to write details about.
+/// @param sync Whether the test case synchronized.
+/// @param frameCount The number of frames in the test case's KRKG.
+void KTestSystem::writeTestOutput(const TestCase &testCase, bool sync, u16 frameCount) const {
+    std::string outStr(testCase.name.data());
+    outStr += "\n" + std::string(sync ? "1" : "0") + "\n";
+    outStr += std::to_string(testCase.targetFrame) + "\n";
+    outStr += std::to_string(frameCount) + "\n";
     Abstract::File::Append("results.txt", outStr.c_str(), outStr.size());
 }
 
 /// @brief Gets the current test case.
-/// @details In the event that there is no active test case, this gets the next test case.
 /// @return The current test case.
 const KTestSystem::TestCase &KTestSystem::getCurrentTestCase() const {
-    ASSERT(!m_testCases.empty());
-    return m_testCases.front();
+    ASSERT(m_currentTestCase < m_testCases.size());
+    return m_testCases[m_currentTestCase];
 }
 
 /// @brief Initializes the race configuration as needed for test cases.
 /// @param config The race configuration instance.
 /// @param arg Unused optional argument.
 void KTestSystem::OnInit(System::RaceConfig *config, void * /* arg */) {
-    size_t size;
-    u8 *rkg = Abstract::File::Load(Instance()->getCurrentTestCase().rkgPath.data(), size);
-    config->setGhost(rkg);
-    delete[] rkg;
+    Abstract::File::MappedFile rkg(Instance()->getCurrentTestCase().rkgPath.data());
+    config->setGhost(0, rkg.data());
 
     config->raceScenario().players[0].type = System::RaceConfig::Player::Type::Ghost;
 }
+
+/// @brief Forwards the first kart's stages to the trace.
+/// @param stage The stage the kart has reached.
+/// @param playerIdx The index of the kart.
+/// @param arg The Host::StateTrace.
+void KTestSystem::OnKartStage(Kart::CalcStage stage, u8 playerIdx, void *arg) {
+    if (playerIdx == 0) {
+        reinterpret_cast<Host::StateTrace *>(arg)->calcStage(stage);
+    }
+}
+
+/// @brief Runs a single test case inside of a worker process.
+/// @details Each worker initializes the scenes on its first test case, and afterwards restarts the
+/// race scene.
+/// @param job The index of the test case.
+/// @param record The test case's TestResult.
+/// @param arg Unused optional argument.
+void KTestSystem::RunWorkerJob(u32 job, void *record, void * /* arg */) {
+    auto *system = Instance();
+    auto *sceneMgr = system->m_sceneMgr;
+    system->m_currentTestCase = job;
+
+    if (sceneMgr->currentScene()) {
+        system->restartRace();
+    } else {
+        system->startNextTestCase();
+        sceneMgr->changeScene(0);
+        system->saveWarmState();
+    }
+
+    auto *result = reinterpret_cast<TestResult *>(record);
+    result->sync = system->runTest();
+    result->frameCount = system->m_frameCount;
+
+    system->m_streamFile->reset();
+}
@@ -1,15 +1,28 @@
 #pragma once
 
 #include "host/KSystem.hh"
+#include "host/RewindBuffer.hh"
+#include "host/StateTrace.hh"
 
 #include <egg/core/SceneManager.hh>
 #include <egg/math/Quat.hh>
 
 #include <game/system/RaceConfig.hh>
 
-#include <queue>
+#include <abstract/File.hh>
+
+#include <vector>
 
 /// @brief Kinoko system designed to execute tests.
+/// @details With the trace flag, the system records a Host::StateTrace of each test case into the
+/// given directory. With the bisect flag, it instead keeps periodic snapshots of each test case.
+/// When a test case desyncs, the system rewinds to the latest snapshot which still matches the
+/// test case's trace, and replays it with the trace comparing every stage of every frame, to find
+/// the first subsystem which diverged from the build which recorded the trace.
+///
+/// Consecutive test cases on the same course, character, vehicle and drift type do not recreate the
+/// race scene. Instead, the system restores a snapshot taken right after the scene initialized its
+/// engines, and swaps in the next ghost's inputs.
 class KTestSystem final : public KSystem {
 public:
     void init() override;
@@ -29,6 +42,12 @@ private:
         u16 targetFrame;
     };
 
+    /// @brief The outcome of a test case run by a worker process.
+    struct TestResult {
+        bool sync;
+        u16 frameCount;
+    };
+
     struct TestData {
         EGG::Vector3f pos;
         EGG::Quatf fullRot;
@@ -113,21 +132,49 @@ private:
 
     void startNextTestCase();
     bool popTestCase();
+    void restartRace();
+    void saveWarmState();
+    [[nodiscard]] bool isWarmMatch(const System::GhostFile &ghost) const;
 
     bool calcTest();
     TestData findCurrentFrameEntry();
     void testFrame(const TestData &data);
 
     bool runTest();
-    void writeTestOutput() const;
+    bool runWorkers();
+    void beginTrace();
+    void calcTrace();
+    void endTrace();
+    void bisect(u16 desyncFrame);
+    [[nodiscard]] std::string getTracePath() const;
+    void writeTestOutput(const TestCase &testCase, bool sync, u16 frameCount) const;
 
     const TestCase &getCurrentTestCase() const;
 
     static void OnInit(System::RaceConfig *config, void *arg);
+    static void RunWorkerJob(u32 job, void *record, void *arg);
+    static void OnKartStage(Kart::CalcStage stage, u8 playerIdx, void *arg);
+
+    /// @brief The number of frames between snapshots when bisecting.
+    static constexpr u32 SNAPSHOT_INTERVAL = 60;
 
     EGG::SceneManager *m_sceneMgr;
     EGG::RamStream m_stream;
-    std::queue<TestCase> m_testCases;
+    std::vector<TestCase> m_testCases;
+    u16 m_currentTestCase;
+    u32 m_jobCount; ///< The number of worker processes to run test cases on.
+
+    /// @brief The directory holding a trace per test case, if tracing or bisecting.
+    const char *m_traceDir;
+    bool m_bisect;      ///< Whether to bisect desyncs against the traces rather than record them.
+    bool m_traceLoaded; ///< Whether the current test case has a trace to bisect against.
+
+    // This system is allocated in the arena, so it is restored along with each snapshot. Everything
+    // which must survive a rewind is allocated from the system allocator instead.
+    Host::StateTrace *m_trace;
+    Kinoko::RewindBuffer *m_rewindBuffer;
+    Kinoko::SaveState *m_warmState; ///< The race scene right after its engines were initialized.
+    Abstract::File::MappedFile *m_streamFile; ///< The suite or KRKG which m_stream reads from.
 
     u16 m_versionMajor;
     u16 m_versionMinor;
@@ -26,6 +26,54 @@ std::optional<EOption> CheckFlag(const char *arg) {
             return EOption::Ghost;
         }
 
+        if (strcmp(verbose_arg, "jobs") == 0) {
+            return EOption::Jobs;
+        }
+
+        if (strcmp(verbose_arg, "batch") == 0) {
+            return EOption::Batch;
+        }
+
+        if (strcmp(verbose_arg, "socket") == 0) {
+            return EOption::Socket;
+        }
+
+        if (strcmp(verbose_arg, "trace") == 0) {
+            return EOption::Trace;
+        }
+
+        if (strcmp(verbose_arg, "bisect") == 0) {
+            return EOption::Bisect;
+        }
+
+        if (strcmp(verbose_arg, "heat") == 0) {
+            return EOption::Heat;
+        }
+
+        if (strcmp(verbose_arg, "cache") == 0) {
+            return EOption::Cache;
+        }
+
+        if (strcmp(verbose_arg, "core-pack") == 0) {
+            return EOption::CorePack;
+        }
+
+        if (strcmp(verbose_arg, "course-bundle") == 0) {
+            return EOption::CourseBundle;
+        }
+
+        if (strcmp(verbose_arg, "shared-kcl") == 0) {
+            return EOption::SharedKcl;
+        }
+
+        if (strcmp(verbose_arg, "prism-records") == 0) {
+            return EOption::PrismRecords;
+        }
+
+        if (strcmp(verbose_arg, "block-grid") == 0) {
+            return EOption::BlockGrid;
+        }
+
         return EOption::Invalid;
     } else {
         switch (arg[1]) {
@@ -38,6 +86,42 @@ std::optional<EOption> CheckFlag(const char *arg) {
         case 'G':
         case 'g':
             return EOption::Ghost;
+        case 'J':
+        case 'j':
+            return EOption::Jobs;
+        case 'B':
+        case 'b':
+            return EOption::Batch;
+        case 'U':
+        case 'u':
+            return EOption::Socket;
+        case 'T':
+        case 't':
+            return EOption::Trace;
+        case 'D':
+        case 'd':
+            return EOption::Bisect;
+        case 'H':
+        case 'h':
+            return EOption::Heat;
+        case 'C':
+        case 'c':
+            return EOption::Cache;
+        case 'P':
+        case 'p':
+            return EOption::CorePack;
+        case 'K':
+        case 'k':
+            return EOption::CourseBundle;
+        case 'L':
+        case 'l':
+            return EOption::SharedKcl;
+        case 'R':
+        case 'r':
+            return EOption::PrismRecords;
+        case 'O':
+        case 'o':
+            return EOption::BlockGrid;
         default:
             return EOption::Invalid;
         }
@@ -11,6 +11,18 @@ enum class EOption {
     Mode,
     Suite,
     Ghost,
+    Jobs,
+    Batch,
+    Socket,
+    Trace,
+    Bisect,
+    Heat,
+    Cache,
+    CorePack,
+    CourseBundle,
+    SharedKcl,
+    PrismRecords,
+    BlockGrid,
 };
 
 namespace Option {
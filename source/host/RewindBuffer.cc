@@ -0,0 +1,279 @@
+#include "RewindBuffer.hh"
+
+#include <abstract/memory/ExpHeap.hh>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace Kinoko {
+
+/// @param budget The number of bytes of snapshot data to keep at most. The newest keyframe and its
+/// deltas are always kept, even if they exceed the budget.
+/// @param keyframeInterval The number of frames between keyframes at most.
+RewindBuffer::RewindBuffer(size_t budget, u32 keyframeInterval)
+    : m_context(nullptr), m_budget(budget), m_keyframeInterval(keyframeInterval), m_size(0),
+      m_keyframeCount(0), m_keyframeIdx(0), m_deltaSize(0) {
+    ASSERT(keyframeInterval > 0);
+}
+
+RewindBuffer::~RewindBuffer() = default;
+
+/// @brief Captures the state of the context at the given frame.
+/// @param frame The frame of the race the state belongs to. Frames must be pushed in increasing
+/// order, though not every frame needs to be pushed.
+void RewindBuffer::push(const EngineContext &context, u32 frame) {
+    ASSERT(context.memorySpace);
+    ASSERT(context.memorySize % PAGE_BYTES == 0);
+    ASSERT(m_entries.empty() || m_context == &context);
+    ASSERT(m_entries.empty() || frame > newestFrame());
+
+    m_context = &context;
+    findUsedPages(context);
+
+    bool isKeyframe =
+            m_entries.empty() || frame - m_entries[m_keyframeIdx].frame >= m_keyframeInterval;
+    size_t size = 0;
+
+    if (!isKeyframe) {
+        size = encodeDelta(context);
+        isKeyframe = m_deltaSize + size > m_entries[m_keyframeIdx].data.size();
+    }
+
+    if (isKeyframe) {
+        size = encodeKeyframe(context);
+    }
+
+    Entry &entry = m_entries.emplace_back();
+    entry.frame = frame;
+    entry.isKeyframe = isKeyframe;
+    entry.state = context;
+    entry.data.assign(m_scratch.begin(), m_scratch.begin() + size);
+
+    if (isKeyframe) {
+        m_keyframeIdx = m_entries.size() - 1;
+        m_deltaSize = 0;
+        ++m_keyframeCount;
+    } else {
+        m_deltaSize += size;
+    }
+
+    m_size += GetSize(entry);
+    evict();
+}
+
+/// @brief Restores the latest state captured at or before the given frame.
+/// @details Every frame captured after the restored one is discarded, as the race may diverge from
+/// them once it resumes.
+/// @param frame The frame to rewind to. Set to the frame which was restored.
+/// @return Whether a state was restored. This is false if every captured frame is later.
+bool RewindBuffer::rewind(EngineContext &context, u32 &frame) {
+    if (m_entries.empty() || frame < oldestFrame()) {
+        return false;
+    }
+
+    ASSERT(m_context == &context);
+
+    size_t idx = m_entries.size() - 1;
+    while (m_entries[idx].frame > frame) {
+        --idx;
+    }
+
+    while (m_entries.size() > idx + 1) {
+        const Entry &entry = m_entries.back();
+        m_size -= GetSize(entry);
+        if (entry.isKeyframe) {
+            --m_keyframeCount;
+        }
+
+        m_entries.pop_back();
+    }
+
+    m_keyframeIdx = idx;
+    while (!m_entries[m_keyframeIdx].isKeyframe) {
+        --m_keyframeIdx;
+    }
+
+    m_deltaSize = 0;
+    for (size_t i = m_keyframeIdx; i <= idx; ++i) {
+        Apply(context, m_entries[i]);
+        if (i != m_keyframeIdx) {
+            m_deltaSize += m_entries[i].data.size();
+        }
+    }
+
+    const Entry &entry = m_entries[idx];
+    static_cast<EngineState &>(context) = entry.state;
+
+    // The used pages must be those of the restored frame, rather than the newest one pushed
+    findUsedPages(context);
+    updateShadow(context);
+
+    frame = entry.frame;
+    return true;
+}
+
+/// @brief Discards every captured frame. The buffer may then be used with another context.
+void RewindBuffer::clear() {
+    m_entries.clear();
+    m_context = nullptr;
+    m_size = 0;
+    m_keyframeCount = 0;
+    m_keyframeIdx = 0;
+    m_deltaSize = 0;
+}
+
+/// @brief Encodes every used page of the arena into the scratch buffer.
+/// @return The size of the keyframe.
+size_t RewindBuffer::encodeKeyframe(const EngineContext &context) {
+    const u8 *arena = reinterpret_cast<const u8 *>(context.memorySpace);
+    size_t usedCount = std::count(m_usedPages.begin(), m_usedPages.end(), true);
+
+    size_t size = usedCount * (sizeof(PageHeader) + PAGE_BYTES);
+    if (m_scratch.size() < size) {
+        m_scratch.resize(size);
+    }
+
+    u8 *out = m_scratch.data();
+    for (size_t page = 0; page < m_usedPages.size(); ++page) {
+        if (!m_usedPages[page]) {
+            continue;
+        }
+
+        PageHeader header = {static_cast<u32>(page), 0, ~0ull};
+        memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+
+        memcpy(out, arena + page * PAGE_BYTES, PAGE_BYTES);
+        out += PAGE_BYTES;
+    }
+
+    updateShadow(context);
+    return size;
+}
+
+/// @brief Encodes the lines of the used pages which changed since the previous frame into the
+/// scratch buffer, and updates the shadow to match. Pages the shadow does not hold are encoded
+/// whole, as a rewind cannot know their contents otherwise.
+/// @return The size of the delta.
+size_t RewindBuffer::encodeDelta(const EngineContext &context) {
+    const u8 *arena = reinterpret_cast<const u8 *>(context.memorySpace);
+
+    size_t maxSize = m_usedPages.size() * (sizeof(PageHeader) + PAGE_BYTES);
+    if (m_scratch.size() < maxSize) {
+        m_scratch.resize(maxSize);
+    }
+
+    u8 *out = m_scratch.data();
+    for (size_t page = 0; page < m_usedPages.size(); ++page) {
+        if (!m_usedPages[page]) {
+            continue;
+        }
+
+        const u8 *current = arena + page * PAGE_BYTES;
+        u8 *shadow = m_shadow.data() + page * PAGE_BYTES;
+        u64 lineMask = ~0ull;
+
+        if (m_shadowPages[page]) {
+            if (memcmp(current, shadow, PAGE_BYTES) == 0) {
+                continue;
+            }
+
+            lineMask = 0;
+            for (size_t line = 0; line < LINES_PER_PAGE; ++line) {
+                size_t lineOffset = line * LINE_BYTES;
+                if (memcmp(current + lineOffset, shadow + lineOffset, LINE_BYTES) != 0) {
+                    lineMask |= 1ull << line;
+                }
+            }
+        }
+
+        PageHeader header = {static_cast<u32>(page), 0, lineMask};
+        memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+
+        for (u64 mask = lineMask; mask != 0; mask &= mask - 1) {
+            size_t lineOffset = std::countr_zero(mask) * LINE_BYTES;
+            memcpy(out, current + lineOffset, LINE_BYTES);
+            memcpy(shadow + lineOffset, current + lineOffset, LINE_BYTES);
+            out += LINE_BYTES;
+        }
+
+        m_shadowPages[page] = true;
+    }
+
+    return out - m_scratch.data();
+}
+
+/// @brief Finds the pages of the arena which are not entirely inside a free heap block.
+void RewindBuffer::findUsedPages(const EngineContext &context) {
+    const u8 *arena = reinterpret_cast<const u8 *>(context.memorySpace);
+    m_usedPages.assign(context.memorySize / PAGE_BYTES, true);
+
+    context.visitFree([&](const Abstract::Memory::Region &region) {
+        size_t start = reinterpret_cast<const u8 *>(region.start) - arena;
+        size_t end = reinterpret_cast<const u8 *>(region.end) - arena;
+
+        for (size_t page = (start + PAGE_BYTES - 1) / PAGE_BYTES; page < end / PAGE_BYTES; ++page) {
+            m_usedPages[page] = false;
+        }
+    });
+}
+
+/// @brief Copies the used pages of the arena into the shadow. The used pages must be up to date.
+/// @details Only these pages are rewritten when restoring the current frame, so pages which were
+/// unused are no longer considered part of the shadow.
+void RewindBuffer::updateShadow(const EngineContext &context) {
+    const u8 *arena = reinterpret_cast<const u8 *>(context.memorySpace);
+
+    if (m_shadow.size() != context.memorySize) {
+        m_shadow.resize(context.memorySize);
+    }
+
+    for (size_t page = 0; page < m_usedPages.size(); ++page) {
+        if (m_usedPages[page]) {
+            memcpy(m_shadow.data() + page * PAGE_BYTES, arena + page * PAGE_BYTES, PAGE_BYTES);
+        }
+    }
+
+    m_shadowPages = m_usedPages;
+}
+
+/// @brief Drops the oldest keyframes, along with their deltas, until the buffer fits its budget.
+void RewindBuffer::evict() {
+    while (m_size > m_budget && m_keyframeCount > 1) {
+        do {
+            m_size -= GetSize(m_entries.front());
+            m_entries.pop_front();
+            --m_keyframeIdx;
+        } while (!m_entries.front().isKeyframe);
+
+        --m_keyframeCount;
+    }
+}
+
+/// @brief Writes the pages of a snapshot into the arena.
+void RewindBuffer::Apply(EngineContext &context, const Entry &entry) {
+    u8 *arena = reinterpret_cast<u8 *>(context.memorySpace);
+    const u8 *in = entry.data.data();
+    const u8 *end = in + entry.data.size();
+
+    while (in < end) {
+        PageHeader header;
+        memcpy(&header, in, sizeof(header));
+        in += sizeof(header);
+
+        u8 *page = arena + header.page * PAGE_BYTES;
+        for (u64 mask = header.lineMask; mask != 0; mask &= mask - 1) {
+            memcpy(page + std::countr_zero(mask) * LINE_BYTES, in, LINE_BYTES);
+            in += LINE_BYTES;
+        }
+    }
+}
+
+/// @brief The number of bytes an entry counts towards the budget.
+size_t RewindBuffer::GetSize(const Entry &entry) {
+    return sizeof(Entry) + entry.data.size();
+}
+
+} // namespace Kinoko
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <egg/core/EngineContext.hh>
+
+#include <deque>
+
+namespace Kinoko {
+
+/// @brief A history of per-frame snapshots of an engine context, for rewinding a race.
+/// @details A full SaveState per frame costs the whole used arena, but most frames only write to a
+/// handful of pages, such as the karts' state and a few objects. The buffer therefore stores a
+/// keyframe, which is a copy of every used page, followed by deltas holding only the cache lines
+/// which changed since the previous frame. Changed lines are found by comparing the arena against a
+/// shadow copy of the previous frame, which is exact and needs no page protection or signal
+/// handling. Restoring a frame copies its keyframe and applies each delta up to the frame.
+///
+/// A new keyframe is taken every `keyframeInterval` frames, or sooner once the deltas since the
+/// last keyframe outgrow it, which bounds the cost of a rewind to about two keyframes. When the
+/// buffer exceeds its budget, the oldest keyframe is dropped along with its deltas.
+///
+/// The buffer and its contents are allocated from the system allocator, never from the engine
+/// heaps. Besides the budget, the shadow copy and a scratch buffer each take up to the size of the
+/// arena. Like a SaveState, the buffer shares the archives and KCL arrays of the race.
+class RewindBuffer {
+public:
+    RewindBuffer(size_t budget, u32 keyframeInterval);
+    ~RewindBuffer();
+
+    RewindBuffer(const RewindBuffer &) = delete;
+    RewindBuffer &operator=(const RewindBuffer &) = delete;
+
+    void push(const EngineContext &context, u32 frame);
+    [[nodiscard]] bool rewind(EngineContext &context, u32 &frame);
+    void clear();
+
+    /// @brief Whether the buffer holds no frames.
+    [[nodiscard]] bool empty() const {
+        return m_entries.empty();
+    }
+
+    /// @brief The earliest frame which can be restored. The buffer must not be empty.
+    [[nodiscard]] u32 oldestFrame() const {
+        return m_entries.front().frame;
+    }
+
+    /// @brief The latest frame which can be restored. The buffer must not be empty.
+    [[nodiscard]] u32 newestFrame() const {
+        return m_entries.back().frame;
+    }
+
+    /// @brief The number of bytes of snapshot data held by the buffer.
+    [[nodiscard]] size_t size() const {
+        return m_size;
+    }
+
+    /// @brief The number of keyframes held by the buffer.
+    [[nodiscard]] size_t keyframeCount() const {
+        return m_keyframeCount;
+    }
+
+private:
+    template <typename T>
+    using Vector = std::vector<T, SystemAllocator<T>>;
+
+    /// @brief Precedes the lines of a page in a snapshot.
+    struct PageHeader {
+        u32 page;
+        u32 _pad;
+        u64 lineMask; ///< Bit n is set if line n of the page follows.
+    };
+
+    struct Entry {
+        u32 frame;
+        bool isKeyframe;
+        EngineState state;
+        Vector<u8> data; ///< A PageHeader and its lines for each page in the snapshot.
+    };
+
+    [[nodiscard]] size_t encodeKeyframe(const EngineContext &context);
+    [[nodiscard]] size_t encodeDelta(const EngineContext &context);
+    void findUsedPages(const EngineContext &context);
+    void updateShadow(const EngineContext &context);
+    void evict();
+
+    static void Apply(EngineContext &context, const Entry &entry);
+    [[nodiscard]] static size_t GetSize(const Entry &entry);
+
+    static constexpr size_t PAGE_BYTES = 0x1000;
+    static constexpr size_t LINE_BYTES = 0x40;
+    static constexpr size_t LINES_PER_PAGE = PAGE_BYTES / LINE_BYTES;
+
+    STATIC_ASSERT(LINES_PER_PAGE == 64);
+
+    const EngineContext *m_context; ///< The context the frames were captured from.
+    size_t m_budget;                ///< The number of bytes of snapshot data to keep at most.
+    u32 m_keyframeInterval;         ///< The number of frames between keyframes at most.
+    size_t m_size;                  ///< The number of bytes of snapshot data held.
+    size_t m_keyframeCount;         ///< The number of entries which are keyframes.
+    size_t m_keyframeIdx;           ///< The index of the newest keyframe in the entries.
+    size_t m_deltaSize;             ///< The number of bytes of deltas since the newest keyframe.
+
+    /// @brief The captured frames, in increasing order.
+    std::deque<Entry, SystemAllocator<Entry>> m_entries;
+
+    Vector<bool> m_usedPages;   ///< Pages which are not entirely inside a free heap block.
+    Vector<bool> m_shadowPages; ///< Pages of the shadow which match the newest frame on restore.
+    Vector<u8> m_shadow;        ///< The arena as of the newest frame.
+    Vector<u8> m_scratch;       ///< Holds a snapshot while it is being encoded.
+};
+
+} // namespace Kinoko
@@ -0,0 +1,286 @@
+#include "StateTrace.hh"
+
+#include <game/kart/KartObjectManager.hh>
+#include <game/kart/KartSuspension.hh>
+#include <game/kart/KartTire.hh>
+#include <game/system/RaceManager.hh>
+
+#include <abstract/memory/ExpHeap.hh>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace Host {
+
+StateTrace::StateTrace()
+    : m_mode(Mode::Record), m_frame(0), m_mismatchFrame(0), m_mismatchStage(0),
+      m_mismatchMask(0) {}
+
+/// @brief Prepares to trace a race from its first frame.
+/// @details Recording discards any stored hashes, while comparing keeps them. Must be called after
+/// the race's archives are loaded, so that pointers into them are recognized.
+void StateTrace::begin(Mode mode) {
+    m_mode = mode;
+    m_mismatchMask = 0;
+
+    if (mode == Mode::Record) {
+        m_hashes.clear();
+    }
+
+    findMappings();
+}
+
+/// @brief Hashes the state at the start of a frame.
+/// @param frame The frame about to be calculated. In comparisons, it must be stored in the trace.
+void StateTrace::calcFrame(u32 frame) {
+    m_frame = frame;
+
+    if (m_mode == Mode::Record && m_hashes.size() < (frame + 1) * FRAME_HASH_COUNT) {
+        m_hashes.resize((frame + 1) * FRAME_HASH_COUNT);
+    }
+
+    calc(0);
+}
+
+/// @brief Hashes the state at one of the stages of the current frame.
+void StateTrace::calcStage(Kart::CalcStage stage) {
+    calc(1 + static_cast<size_t>(stage));
+}
+
+/// @brief Reports the first stage at which a comparison found a mismatch, and which subsystems
+/// differed at that stage.
+void StateTrace::report() const {
+    if (!hasMismatch()) {
+        REPORT("No subsystem diverged from the trace");
+        return;
+    }
+
+    REPORT("First divergence: frame %u, %s", m_mismatchFrame, StageName(m_mismatchStage));
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        if (m_mismatchMask & (1u << i)) {
+            REPORT("    %s", SubsystemName(i));
+        }
+    }
+}
+
+/// @brief Writes the stored hashes to a file.
+/// @return Whether the file was written.
+bool StateTrace::save(const char *path) const {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        return false;
+    }
+
+    Header header = {TRACE_SIGNATURE, TRACE_VERSION, STAGE_COUNT, SUBSYSTEM_COUNT, frameCount()};
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(m_hashes.data()), m_hashes.size() * sizeof(u32));
+    return static_cast<bool>(stream);
+}
+
+/// @brief Reads the hashes to compare against from a file.
+/// @return Whether a trace was read. This is false if the file is missing, or was written for a
+/// different set of stages or subsystems.
+bool StateTrace::load(const char *path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return false;
+    }
+
+    Header header;
+    stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!stream || header.signature != TRACE_SIGNATURE || header.version != TRACE_VERSION ||
+            header.stageCount != STAGE_COUNT || header.subsystemCount != SUBSYSTEM_COUNT) {
+        return false;
+    }
+
+    m_hashes.resize(header.frameCount * FRAME_HASH_COUNT);
+    stream.read(reinterpret_cast<char *>(m_hashes.data()), m_hashes.size() * sizeof(u32));
+    return static_cast<bool>(stream);
+}
+
+/// @brief Records or compares the hashes of a stage of the current frame.
+void StateTrace::calc(size_t stage) {
+    u32 hashes[SUBSYSTEM_COUNT];
+    hashKart(hashes);
+
+    u32 *stored = m_hashes.data() + m_frame * FRAME_HASH_COUNT + stage * SUBSYSTEM_COUNT;
+
+    if (m_mode == Mode::Record) {
+        std::copy(hashes, hashes + SUBSYSTEM_COUNT, stored);
+        return;
+    }
+
+    ASSERT(m_frame < frameCount());
+
+    // Only the first mismatch is of interest, as later ones may just be its consequences
+    if (hasMismatch()) {
+        return;
+    }
+
+    for (size_t i = 0; i < SUBSYSTEM_COUNT; ++i) {
+        if (hashes[i] != stored[i]) {
+            m_mismatchMask |= 1u << i;
+        }
+    }
+
+    m_mismatchFrame = m_frame;
+    m_mismatchStage = stage;
+}
+
+/// @brief Finds the address ranges which words must not point into to be hashed.
+/// @details On Linux, these are all mappings of the process. Elsewhere, only the arena is known,
+/// so pointers outside of it are hashed, and traces are only comparable within the same binary.
+void StateTrace::findMappings() {
+    m_mappings.clear();
+
+#ifdef __linux__
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (maps) {
+        char line[256];
+        bool isLineStart = true;
+
+        while (fgets(line, sizeof(line), maps)) {
+            unsigned long start;
+            unsigned long end;
+            if (isLineStart && sscanf(line, "%lx-%lx", &start, &end) == 2) {
+                m_mappings.push_back({start, end});
+            }
+
+            // Long paths span several reads, and only the first contains a range
+            isLineStart = strchr(line, '\n') != nullptr;
+        }
+
+        fclose(maps);
+    }
+#endif
+
+    const auto *context = Kinoko::EngineContext::Current();
+    uintptr_t arena = reinterpret_cast<uintptr_t>(context->memorySpace);
+    m_mappings.push_back({arena, arena + context->memorySize});
+
+    std::sort(m_mappings.begin(), m_mappings.end());
+}
+
+/// @brief Hashes each subsystem of the first kart.
+/// @param hashes Receives one hash per Subsystem.
+void StateTrace::hashKart(u32 *hashes) const {
+    constexpr u32 FNV_OFFSET_BASIS = 0x811C9DC5;
+
+    auto *object = Kart::KartObjectManager::Instance()->object(0);
+
+    auto set = [hashes](Subsystem subsystem, u32 hash) {
+        hashes[static_cast<size_t>(subsystem)] = hash;
+    };
+
+    set(Subsystem::State, hashBlock(object->state(), FNV_OFFSET_BASIS));
+    set(Subsystem::Move, hashBlock(object->move(), FNV_OFFSET_BASIS));
+    set(Subsystem::Jump, hashBlock(object->jump(), FNV_OFFSET_BASIS));
+    set(Subsystem::HalfPipe, hashBlock(object->halfPipe(), FNV_OFFSET_BASIS));
+    set(Subsystem::Collide, hashBlock(object->collide(), FNV_OFFSET_BASIS));
+    set(Subsystem::Body, hashBlock(object->body(), FNV_OFFSET_BASIS));
+    set(Subsystem::Physics, hashBlock(object->physics(), FNV_OFFSET_BASIS));
+    set(Subsystem::Dynamics, hashBlock(object->dynamics(), FNV_OFFSET_BASIS));
+    set(Subsystem::Hitboxes, hashBlock(object->collisionGroup(), FNV_OFFSET_BASIS));
+    set(Subsystem::Sub, hashBlock(object->sub(), FNV_OFFSET_BASIS));
+    set(Subsystem::ObjectCollision, hashBlock(object->objectCollisionKart(), FNV_OFFSET_BASIS));
+
+    u32 suspensions = FNV_OFFSET_BASIS;
+    for (u16 i = 0; i < object->suspCount(); ++i) {
+        suspensions = hashBlock(object->suspension(i), suspensions);
+        suspensions = hashBlock(object->suspensionPhysics(i), suspensions);
+    }
+    set(Subsystem::Suspensions, suspensions);
+
+    u32 tires = FNV_OFFSET_BASIS;
+    for (u16 i = 0; i < object->tireCount(); ++i) {
+        tires = hashBlock(object->tire(i), tires);
+        tires = hashBlock(object->tirePhysics(i), tires);
+        tires = hashBlock(object->tirePhysics(i)->hitboxGroup(), tires);
+    }
+    set(Subsystem::Tires, tires);
+
+    const auto &player = System::RaceManager::Instance()->player(0);
+    set(Subsystem::Player, hash(&player, sizeof(player), FNV_OFFSET_BASIS));
+}
+
+/// @brief Hashes a heap block, which covers the whole object even if it is of a derived class.
+u32 StateTrace::hashBlock(const void *block, u32 hash) const {
+    return this->hash(block, Abstract::Memory::MEMiExpHeapHead::getSizeForMBlock(block), hash);
+}
+
+/// @brief Hashes memory with FNV-1a, replacing words which point into a mapping with zero.
+/// @details Pointers are 8-byte aligned within an object, so the words are taken relative to the
+/// start of the data rather than to address zero.
+u32 StateTrace::hash(const void *data, size_t size, u32 hash) const {
+    constexpr u32 FNV_PRIME = 0x01000193;
+
+    const u8 *bytes = reinterpret_cast<const u8 *>(data);
+    size_t offset = 0;
+
+    for (; offset + sizeof(u64) <= size; offset += sizeof(u64)) {
+        u64 word;
+        memcpy(&word, bytes + offset, sizeof(word));
+        if (isMapped(word)) {
+            word = 0;
+        }
+
+        for (size_t i = 0; i < sizeof(word); ++i) {
+            hash = (hash ^ static_cast<u8>(word >> (i * 8))) * FNV_PRIME;
+        }
+    }
+
+    for (; offset < size; ++offset) {
+        hash = (hash ^ bytes[offset]) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/// @brief Whether the word is an address inside one of the mappings.
+bool StateTrace::isMapped(u64 word) const {
+    auto it = std::upper_bound(m_mappings.begin(), m_mappings.end(), word,
+            [](u64 value, const std::pair<uintptr_t, uintptr_t> &mapping) {
+                return value < mapping.first;
+            });
+
+    return it != m_mappings.begin() && word < std::prev(it)->second;
+}
+
+const char *StateTrace::StageName(size_t stage) {
+    static constexpr std::array<const char *, STAGE_COUNT> NAMES = {{
+            "before the frame",
+            "after KartSub::calcPass0",
+            "after the object collision pass",
+            "after the course collision pass",
+            "after the suspension collision pass",
+            "after KartSub::calcPass1",
+    }};
+
+    ASSERT(stage < NAMES.size());
+    return NAMES[stage];
+}
+
+const char *StateTrace::SubsystemName(size_t subsystem) {
+    static constexpr std::array<const char *, SUBSYSTEM_COUNT> NAMES = {{
+            "KartState",
+            "KartMove",
+            "KartJump",
+            "KartHalfPipe",
+            "KartCollide",
+            "KartBody",
+            "KartPhysics",
+            "KartDynamics",
+            "CollisionGroup",
+            "KartSub",
+            "KartSuspension",
+            "KartTire",
+            "ObjectCollisionKart",
+            "RaceManager::Player",
+    }};
+
+    ASSERT(subsystem < NAMES.size());
+    return NAMES[subsystem];
+}
+
+} // namespace Host
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <egg/core/EngineContext.hh>
+
+#include <game/kart/KartSub.hh>
+
+#include <utility>
+
+namespace Host {
+
+/// @brief Per-frame hashes of each subsystem of the first kart, used to find where a race diverges
+/// from a reference run.
+/// @details Hashes are taken at the start of every frame and at each Kart::CalcStage. They cover
+/// the raw memory of each subsystem, skipping any word which points into a mapping of the process,
+/// as addresses differ across processes and builds. Hashes therefore only change when the state of
+/// the subsystem does, so traces recorded by one build can be compared against another.
+///
+/// The trace is allocated from the system allocator, as it must survive restoring a snapshot.
+class StateTrace {
+public:
+    enum class Mode {
+        Record,  ///< Stores the hashes of each frame.
+        Compare, ///< Compares the hashes of each frame against the stored ones.
+    };
+
+    enum class Subsystem {
+        State,
+        Move,
+        Jump,
+        HalfPipe,
+        Collide,
+        Body,
+        Physics,
+        Dynamics,
+        Hitboxes,
+        Sub,
+        Suspensions,
+        Tires,
+        ObjectCollision,
+        Player,
+        Count,
+    };
+
+    StateTrace();
+
+    void begin(Mode mode);
+    void calcFrame(u32 frame);
+    void calcStage(Kart::CalcStage stage);
+    void report() const;
+
+    [[nodiscard]] bool save(const char *path) const;
+    [[nodiscard]] bool load(const char *path);
+
+    /// @brief Whether a comparison has found a hash which differs from the stored one.
+    [[nodiscard]] bool hasMismatch() const {
+        return m_mismatchMask != 0;
+    }
+
+    /// @brief The number of frames the trace holds hashes for.
+    [[nodiscard]] u32 frameCount() const {
+        return m_hashes.size() / FRAME_HASH_COUNT;
+    }
+
+private:
+    /// @brief The stages at which hashes are taken. Start precedes the frame, and the rest follow
+    /// the Kart::CalcStage of the same name.
+    static constexpr size_t STAGE_COUNT = 6;
+    static constexpr size_t SUBSYSTEM_COUNT = static_cast<size_t>(Subsystem::Count);
+    static constexpr size_t FRAME_HASH_COUNT = STAGE_COUNT * SUBSYSTEM_COUNT;
+
+    static constexpr u32 TRACE_SIGNATURE = 0x4b545243; // KTRC
+    static constexpr u16 TRACE_VERSION = 1;
+
+    STATIC_ASSERT(SUBSYSTEM_COUNT <= 32);
+
+    struct Header {
+        u32 signature;
+        u16 version;
+        u8 stageCount;
+        u8 subsystemCount;
+        u32 frameCount;
+    };
+
+    void calc(size_t stage);
+    void findMappings();
+    void hashKart(u32 *hashes) const;
+    [[nodiscard]] u32 hashBlock(const void *block, u32 hash) const;
+    [[nodiscard]] u32 hash(const void *data, size_t size, u32 hash) const;
+    [[nodiscard]] bool isMapped(u64 word) const;
+
+    static const char *StageName(size_t stage);
+    static const char *SubsystemName(size_t subsystem);
+
+    Mode m_mode;
+    u32 m_frame; ///< The frame currently being calculated.
+
+    std::vector<u32, Kinoko::SystemAllocator<u32>> m_hashes;
+
+    /// @brief The sorted address ranges of the mappings of the process, as [start, end).
+    std::vector<std::pair<uintptr_t, uintptr_t>,
+            Kinoko::SystemAllocator<std::pair<uintptr_t, uintptr_t>>>
+            m_mappings;
+
+    u32 m_mismatchFrame;
+    size_t m_mismatchStage;
+    u32 m_mismatchMask; ///< Bit n is set if subsystem n differs at the mismatching stage.
+};
+
+} // namespace Host
@@ -0,0 +1,255 @@
+#include "WorkerPool.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define WORKER_POOL_FORK
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace Host {
+
+static constexpr size_t AlignUp(size_t size, size_t align) {
+    return (size + align - 1) & ~(align - 1);
+}
+
+static u64 Now() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+/// @param jobCount The number of jobs in the batch.
+/// @param recordSize The size of the record each job writes.
+WorkerPool::WorkerPool(u32 jobCount, size_t recordSize)
+    : m_jobCount(jobCount), m_workerCount(0), m_recordSize(AlignUp(recordSize, 8)),
+      m_wallTime(0) {
+    // There is never a use for more workers than jobs, so there is a range per job at most
+    m_queueOffset = sizeof(std::atomic<u64>) * jobCount;
+    m_doneOffset = m_queueOffset + sizeof(u32) * jobCount;
+    m_statsOffset = AlignUp(m_doneOffset + jobCount, 8);
+    m_recordsOffset = m_statsOffset + sizeof(JobStats) * jobCount;
+    m_mappingSize = std::max<size_t>(m_recordsOffset + m_recordSize * jobCount, 1);
+
+    // The shared state lives outside of the engine heaps, as the workers' heaps are private
+#ifdef WORKER_POOL_FORK
+    void *mapping = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+            -1, 0);
+    if (mapping == MAP_FAILED) {
+        PANIC("Failed to map %zu bytes of shared memory for the worker pool!", m_mappingSize);
+    }
+#else
+    void *mapping = std::calloc(1, m_mappingSize);
+#endif
+
+    m_mapping = reinterpret_cast<u8 *>(mapping);
+
+    for (u32 i = 0; i < jobCount; ++i) {
+        new (&ranges()[i]) std::atomic<u64>(0);
+        new (&doneFlags()[i]) std::atomic<u8>(0);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+#ifdef WORKER_POOL_FORK
+    munmap(m_mapping, m_mappingSize);
+#else
+    std::free(m_mapping);
+#endif
+}
+
+/// @brief Runs every job in the batch and waits for the workers to finish.
+/// @param queues The jobs each worker runs, in order. There is one process per queue, and every
+/// job must appear in exactly one queue.
+/// @param job The function executing a single job.
+/// @param arg An optional argument forwarded to the job function.
+/// @return Whether every job ran to completion.
+bool WorkerPool::run(const std::vector<std::vector<u32>> &queues, const Job &job, void *arg) {
+    ASSERT(!queues.empty() && queues.size() <= std::max<u32>(m_jobCount, 1));
+
+    m_workerCount = queues.size();
+
+    u32 offset = 0;
+    for (u32 i = 0; i < m_workerCount; ++i) {
+        const auto &queue = queues[i];
+        ASSERT(offset + queue.size() <= m_jobCount);
+
+        std::copy(queue.begin(), queue.end(), queueJobs() + offset);
+        ranges()[i].store(PackRange(offset, offset + queue.size()));
+        offset += queue.size();
+    }
+
+    ASSERT(offset == m_jobCount);
+
+    u64 start = Now();
+
+#ifdef WORKER_POOL_FORK
+    // Buffered output would otherwise be duplicated into each worker
+    fflush(stdout);
+
+    u32 forked = 0;
+    for (u32 i = 0; i < m_workerCount; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            work(i, job, arg);
+            fflush(stdout);
+            _exit(0);
+        }
+
+        if (pid < 0) {
+            WARN("Failed to fork worker %u! Its jobs will be stolen by the other workers", i);
+            continue;
+        }
+
+        ++forked;
+    }
+
+    if (forked == 0) {
+        for (u32 i = 0; i < m_workerCount; ++i) {
+            work(i, job, arg);
+        }
+    }
+
+    for (u32 i = 0; i < forked; ++i) {
+        int status;
+        pid_t pid = wait(&status);
+        if (pid > 0 && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+            WARN("Worker %d exited abnormally!", pid);
+        }
+    }
+#else
+    for (u32 i = 0; i < m_workerCount; ++i) {
+        work(i, job, arg);
+    }
+#endif
+
+    m_wallTime = Now() - start;
+
+    bool finished = true;
+    for (u32 i = 0; i < m_jobCount; ++i) {
+        finished &= isDone(i);
+    }
+
+    return finished;
+}
+
+/// @brief Whether the job's worker completed it. Jobs whose worker crashed are never done.
+bool WorkerPool::isDone(u32 job) const {
+    ASSERT(job < m_jobCount);
+    return doneFlags()[job].load() != 0;
+}
+
+const void *WorkerPool::record(u32 job) const {
+    ASSERT(job < m_jobCount);
+    return records() + m_recordSize * job;
+}
+
+/// @brief The worker which ran the job. The job must be done.
+u32 WorkerPool::worker(u32 job) const {
+    ASSERT(isDone(job));
+    return stats()[job].worker;
+}
+
+/// @brief The time the job took, in nanoseconds. The job must be done.
+u64 WorkerPool::elapsed(u32 job) const {
+    ASSERT(isDone(job));
+    return stats()[job].elapsed;
+}
+
+/// @brief Executes the worker's own queue, then steals from the other queues until all are empty.
+void WorkerPool::work(u32 worker, const Job &job, void *arg) {
+    u32 idx;
+    while (pop(worker, idx) || steal(worker, idx)) {
+        u64 start = Now();
+        job(idx, records() + m_recordSize * idx, arg);
+
+        JobStats &jobStats = stats()[idx];
+        jobStats.worker = worker;
+        jobStats.elapsed = Now() - start;
+        doneFlags()[idx].store(1);
+    }
+}
+
+/// @brief Takes the next job from the front of the worker's own queue.
+/// @return Whether a job was taken.
+bool WorkerPool::pop(u32 worker, u32 &idx) {
+    auto &range = ranges()[worker];
+    u64 packed = range.load();
+
+    while (true) {
+        u32 head = static_cast<u32>(packed);
+        u32 tail = static_cast<u32>(packed >> 32);
+        if (head == tail) {
+            return false;
+        }
+
+        if (range.compare_exchange_weak(packed, PackRange(head + 1, tail))) {
+            idx = queueJobs()[head];
+            return true;
+        }
+    }
+}
+
+/// @brief Takes the last job from the back of the queue with the most jobs left.
+/// @details Stealing from the back leaves the victim's upcoming jobs, which share its course, in
+/// place for the victim.
+/// @return Whether a job was taken, which is false once every queue is empty.
+bool WorkerPool::steal(u32 worker, u32 &idx) {
+    while (true) {
+        u32 victim = worker;
+        u32 mostLeft = 0;
+
+        for (u32 i = 0; i < m_workerCount; ++i) {
+            u64 packed = ranges()[i].load();
+            u32 left = static_cast<u32>(packed >> 32) - static_cast<u32>(packed);
+            if (left > mostLeft) {
+                victim = i;
+                mostLeft = left;
+            }
+        }
+
+        if (mostLeft == 0) {
+            return false;
+        }
+
+        auto &range = ranges()[victim];
+        u64 packed = range.load();
+        u32 head = static_cast<u32>(packed);
+        u32 tail = static_cast<u32>(packed >> 32);
+
+        // Another worker got there first, so look for a victim again
+        if (head == tail || !range.compare_exchange_strong(packed, PackRange(head, tail - 1))) {
+            continue;
+        }
+
+        idx = queueJobs()[tail - 1];
+        return true;
+    }
+}
+
+/// @brief The remaining part of each worker's queue, as indices into the queued jobs.
+std::atomic<u64> *WorkerPool::ranges() const {
+    return reinterpret_cast<std::atomic<u64> *>(m_mapping);
+}
+
+/// @brief The job indices of every queue, back to back.
+u32 *WorkerPool::queueJobs() const {
+    return reinterpret_cast<u32 *>(m_mapping + m_queueOffset);
+}
+
+std::atomic<u8> *WorkerPool::doneFlags() const {
+    return reinterpret_cast<std::atomic<u8> *>(m_mapping + m_doneOffset);
+}
+
+WorkerPool::JobStats *WorkerPool::stats() const {
+    return reinterpret_cast<JobStats *>(m_mapping + m_statsOffset);
+}
+
+u8 *WorkerPool::records() const {
+    return m_mapping + m_recordsOffset;
+}
+
+} // namespace Host
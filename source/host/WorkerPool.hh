@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Common.hh>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace Host {
+
+/// @brief Runs a batch of jobs across forked worker processes.
+/// @details Workers are forked from the calling process, so they inherit its memory copy-on-write.
+/// Anything loaded before the call to run, such as archives in the System::ArchiveCache, is
+/// therefore shared by all workers without being loaded again. Each worker runs its own queue of
+/// job indices, as planned by a Host::JobScheduler. Once its queue is empty, a worker steals the
+/// last jobs of the fullest remaining queue, so that a poor estimate of a job's cost cannot leave
+/// the other workers idle. The queues live in shared memory, along with the time each job took and
+/// a fixed-size record per job which the parent reads back once all workers have exited. On
+/// platforms without fork, the jobs run in the calling process.
+class WorkerPool {
+public:
+    /// @brief Executes a single job inside of a worker.
+    /// @param job The index of the job.
+    /// @param record The job's zero-initialized record, which is visible to the parent.
+    /// @param arg The argument passed into run.
+    typedef std::function<void(u32 job, void *record, void *arg)> Job;
+
+    WorkerPool(u32 jobCount, size_t recordSize);
+    ~WorkerPool();
+
+    bool run(const std::vector<std::vector<u32>> &queues, const Job &job, void *arg);
+
+    [[nodiscard]] bool isDone(u32 job) const;
+    [[nodiscard]] const void *record(u32 job) const;
+    [[nodiscard]] u32 worker(u32 job) const;
+    [[nodiscard]] u64 elapsed(u32 job) const;
+
+    /// @brief The wall-clock time the last run took, in nanoseconds.
+    [[nodiscard]] u64 wallTime() const {
+        return m_wallTime;
+    }
+
+private:
+    /// @brief The outcome of a job, besides its record.
+    struct JobStats {
+        u32 worker;  ///< The worker which ran the job.
+        u32 _pad;
+        u64 elapsed; ///< The time the job took, in nanoseconds.
+    };
+
+    void work(u32 worker, const Job &job, void *arg);
+    [[nodiscard]] bool pop(u32 worker, u32 &idx);
+    [[nodiscard]] bool steal(u32 worker, u32 &idx);
+
+    [[nodiscard]] std::atomic<u64> *ranges() const;
+    [[nodiscard]] u32 *queueJobs() const;
+    [[nodiscard]] std::atomic<u8> *doneFlags() const;
+    [[nodiscard]] JobStats *stats() const;
+    [[nodiscard]] u8 *records() const;
+
+    /// @brief Packs the bounds of the remaining part of a queue, so both can be swapped atomically.
+    static u64 PackRange(u32 head, u32 tail) {
+        return static_cast<u64>(tail) << 32 | head;
+    }
+
+    u32 m_jobCount;
+    u32 m_workerCount;
+    size_t m_recordSize;
+    size_t m_mappingSize;
+    u64 m_wallTime;
+
+    // The offsets of each array from the start of the shared memory
+    size_t m_queueOffset;
+    size_t m_doneOffset;
+    size_t m_statsOffset;
+    size_t m_recordsOffset;
+
+    u8 *m_mapping; ///< The start of the memory shared between the workers.
+};
+
+} // namespace Host
@@ -1,46 +1,25 @@
+#include "host/KBenchSystem.hh"
+#include "host/KDaemonSystem.hh"
 #include "host/KReplaySystem.hh"
 #include "host/KTestSystem.hh"
 #include "host/Option.hh"
 
-#include <egg/core/ExpHeap.hh>
+#include <egg/core/EngineContext.hh>
 
-#if defined(__arm64__) || defined(__aarch64__)
-static void FlushDenormalsToZero() {
-    uint64_t fpcr;
-    asm("mrs %0,   fpcr" : "=r"(fpcr));
-    asm("msr fpcr, %0" ::"r"(fpcr | (1 << 24)));
-}
-#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
-#include <immintrin.h>
-
-static void FlushDenormalsToZero() {
-    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
-}
-#endif
+#include <game/field/KColDataCache.hh>
+#include <game/system/ArchiveDiskCache.hh>
+#include <game/system/CourseBundle.hh>
+#include <game/system/ResourceManager.hh>
 
-static void *s_memorySpace = nullptr;
-static EGG::Heap *s_rootHeap = nullptr;
+#include <cstdlib>
+#include <vector>
 
-static void InitMemory() {
+int main(int argc, char **argv) {
     constexpr size_t MEMORY_SPACE_SIZE = 0x1000000;
-    Abstract::Memory::MEMiHeapHead::OptFlag opt;
-    opt.setBit(Abstract::Memory::MEMiHeapHead::eOptFlag::ZeroFillAlloc);
-
-#ifdef BUILD_DEBUG
-    opt.setBit(Abstract::Memory::MEMiHeapHead::eOptFlag::DebugFillAlloc);
-#endif
 
-    s_memorySpace = malloc(MEMORY_SPACE_SIZE);
-    s_rootHeap = EGG::ExpHeap::create(s_memorySpace, MEMORY_SPACE_SIZE, opt);
-    s_rootHeap->setName("EGGRoot");
-    s_rootHeap->becomeCurrentHeap();
-
-    EGG::SceneManager::SetRootHeap(s_rootHeap);
-}
-
-int main(int argc, char **argv) {
-    FlushDenormalsToZero();
-    InitMemory();
+    Kinoko::EngineContext *context = Kinoko::EngineContext::Default();
+    context->bind();
+    context->initMemory(MEMORY_SPACE_SIZE);
 
     // The hashmap cannot be constexpr, as it heap-allocates
     // Therefore, it cannot be static, as memory needs to be initialized first
@@ -48,6 +27,8 @@ int main(int argc, char **argv) {
     const std::unordered_map<std::string, std::function<KSystem *()>> modeMap = {
             {"test", []() -> KSystem * { return KTestSystem::CreateInstance(); }},
             {"replay", []() -> KSystem * { return KReplaySystem::CreateInstance(); }},
+            {"daemon", []() -> KSystem * { return KDaemonSystem::CreateInstance(); }},
+            {"bench", []() -> KSystem * { return KBenchSystem::CreateInstance(); }},
     };
 
     if (argc < 3) {
@@ -77,7 +58,50 @@ int main(int argc, char **argv) {
         PANIC("Invalid mode!");
     }
 
-    sys->parseOptions(argc - 3, argv + 3);
+    // Generic options apply to every mode, so they are removed before the system parses the rest
+    std::vector<char *> args;
+    for (int i = 3; i < argc; ++i) {
+        std::optional<Host::EOption> option = Host::Option::CheckFlag(argv[i]);
+        if (option == Host::EOption::Cache) {
+            ASSERT(i + 1 < argc);
+            System::ArchiveDiskCache::SetDirectory(argv[i + 1]);
+            Field::KColDataCache::SetDirectory(argv[++i]);
+            continue;
+        }
+
+        if (option == Host::EOption::CorePack) {
+            ASSERT(i + 1 < argc);
+            System::ResourceManager::SetCorePack(argv[++i]);
+            continue;
+        }
+
+        if (option == Host::EOption::CourseBundle) {
+            ASSERT(i + 1 < argc);
+            System::CourseBundle::Open(argv[++i]);
+            continue;
+        }
+
+        if (option == Host::EOption::SharedKcl) {
+            Field::KColDataCache::EnableShared();
+            continue;
+        }
+
+        if (option == Host::EOption::PrismRecords) {
+            Field::KColData::EnablePrismRecords();
+            continue;
+        }
+
+        if (option == Host::EOption::BlockGrid) {
+            ASSERT(i + 1 < argc);
+            size_t budget = strtoul(argv[++i], nullptr, 10);
+            Field::KColData::SetBlockGridBudget(budget * 1024 * 1024);
+            continue;
+        }
+
+        args.push_back(argv[i]);
+    }
+
+    sys->parseOptions(args.size(), args.data());
     sys->init();
     return sys->run() ? 0 : 1;
 }
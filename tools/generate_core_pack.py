@@ -0,0 +1,265 @@
+import os
+import struct
+from argparse import ArgumentParser
+
+# Files which Kinoko reads from the core archive, besides the vehicle BSPs in /bsp
+CORE_FILES = [
+    'kartParam.bin',
+    'driverParam.bin',
+    'bikePartsDispParam.bin',
+    'ObjFlow.bin',
+    'GeoHitTableKart.bin',
+    'GeoHitTableKartObj.bin',
+]
+
+BSP_DIRECTORY = 'bsp'
+BSP_EXTENSION = '.bsp'
+
+U8_SIGNATURE = 0x55AA382D
+U8_HEADER_SIZE = 0x20
+U8_NODE_SIZE = 0xC
+
+# File data is aligned like in the game's archives, so that it can be read in place
+DATA_ALIGNMENT = 0x20
+
+def align(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+def decode_yaz0(data):
+    if data[:4] != b'Yaz0' and data[:4] != b'Yaz1':
+        raise ValueError("Not a Yaz0 compressed file")
+
+    expand_size = struct.unpack_from('>I', data, 4)[0]
+    out = bytearray()
+    pos = 0x10
+
+    while len(out) < expand_size:
+        code = data[pos]
+        pos += 1
+
+        for bit in range(8):
+            if len(out) >= expand_size:
+                break
+
+            if code & (0x80 >> bit):
+                out.append(data[pos])
+                pos += 1
+                continue
+
+            b1 = data[pos]
+            b2 = data[pos + 1]
+            pos += 2
+
+            dist = ((b1 & 0xF) << 8 | b2) + 1
+            length = b1 >> 4
+            if length == 0:
+                length = data[pos] + 0x12
+                pos += 1
+            else:
+                length += 2
+
+            start = len(out) - dist
+            if dist >= length:
+                out += out[start:start + length]
+            else:
+                # The copy overlaps the bytes it produces, so it must be done a byte at a time
+                for i in range(length):
+                    out.append(out[start + i])
+
+    return bytes(out)
+
+class Node:
+    def __init__(self, is_dir, name, a, b):
+        self.is_dir = is_dir
+        self.name = name
+        # Directories hold their parent and the index after their last descendant. Files hold the
+        # offset and length of their data.
+        self.a = a
+        self.b = b
+
+class U8Archive:
+    def __init__(self, data):
+        signature, nodes_offset, _, _ = struct.unpack_from('>4I', data, 0)
+        if signature != U8_SIGNATURE:
+            raise ValueError("Not a U8 archive")
+
+        count = struct.unpack_from('>I', data, nodes_offset + 8)[0]
+        strings_offset = nodes_offset + count * U8_NODE_SIZE
+
+        self.data = data
+        self.nodes = []
+        for i in range(count):
+            val, a, b = struct.unpack_from('>3I', data, nodes_offset + i * U8_NODE_SIZE)
+            name_start = strings_offset + (val & 0xFFFFFF)
+            name_end = data.index(b'\x00', name_start)
+            name = data[name_start:name_end].decode('ascii')
+            self.nodes.append(Node(val >> 24 != 0, name, a, b))
+
+    # Mirrors Abstract::ArchiveHandle::convertPathToEntryId, so that the pack holds exactly the
+    # files which the game would find, even where its prefix matching picks an unexpected one
+    def resolve(self, path):
+        entry = 0
+
+        while True:
+            if path == '':
+                return entry
+
+            if path[0] == '/':
+                entry = 0
+                path = path[1:]
+                continue
+
+            if path == '.':
+                return entry
+
+            if path.startswith('./'):
+                path = path[2:]
+                continue
+
+            if path.startswith('..'):
+                raise ValueError("Parent directories are not supported")
+
+            name = path.split('/', 1)[0]
+            end_of_path = name == path
+
+            anchor = entry
+            entry += 1
+            found = False
+            while entry < self.nodes[anchor].b:
+                if not self.nodes[anchor].is_dir and end_of_path:
+                    entry += 1
+                    continue
+
+                entry_name = self.nodes[entry].name
+                if entry_name == '.':
+                    entry += 1
+                    continue
+
+                if entry_name.startswith(name):
+                    found = True
+                    break
+
+                entry += 1
+
+            if not found:
+                return -1
+
+            if end_of_path:
+                return entry
+
+            path = path[len(name) + 1:]
+
+    def read(self, path):
+        entry = self.resolve(path)
+        if entry < 0 or self.nodes[entry].is_dir:
+            return None
+
+        node = self.nodes[entry]
+        return self.data[node.a:node.a + node.b]
+
+def collect_files(archive):
+    files = {}
+
+    for name in CORE_FILES:
+        data = archive.read(name)
+        if data is None:
+            raise ValueError(f"{name} is missing from the core archive")
+        files[name] = data
+
+    bsp_entry = archive.resolve(BSP_DIRECTORY)
+    if bsp_entry < 0 or not archive.nodes[bsp_entry].is_dir:
+        raise ValueError(f"/{BSP_DIRECTORY} is missing from the core archive")
+
+    bsps = {}
+    for entry in range(bsp_entry + 1, archive.nodes[bsp_entry].b):
+        node = archive.nodes[entry]
+        if node.is_dir or not node.name.endswith(BSP_EXTENSION) or node.name in bsps:
+            continue
+
+        # Keep the file that the game would find under this name
+        data = archive.read(f'{BSP_DIRECTORY}/{node.name}')
+        if data is not None:
+            bsps[node.name] = data
+
+    return files, bsps
+
+def build_pack(files, bsps):
+    # Root files come first, followed by the BSP directory and its files
+    nodes = [(True, '')]
+    nodes += [(False, name) for name in files]
+    nodes.append((True, BSP_DIRECTORY))
+    nodes += [(False, name) for name in bsps]
+
+    strings = bytearray()
+    string_offsets = []
+    for _, name in nodes:
+        string_offsets.append(len(strings))
+        strings += name.encode('ascii') + b'\x00'
+
+    nodes_size = len(nodes) * U8_NODE_SIZE + len(strings)
+    files_offset = align(U8_HEADER_SIZE + nodes_size, DATA_ALIGNMENT)
+
+    contents = list(files.values()) + list(bsps.values())
+    offsets = []
+    size = files_offset
+    for data in contents:
+        offsets.append(size)
+        size = align(size + len(data), DATA_ALIGNMENT)
+
+    out = bytearray(size)
+    struct.pack_into('>4I', out, 0, U8_SIGNATURE, U8_HEADER_SIZE, nodes_size, files_offset)
+
+    file_index = 0
+    for i, (is_dir, _) in enumerate(nodes):
+        val = (1 << 24 if is_dir else 0) | string_offsets[i]
+        if is_dir:
+            # Both directories are children of the root and end with the archive
+            a, b = 0, len(nodes)
+        else:
+            a, b = offsets[file_index], len(contents[file_index])
+            file_index += 1
+        struct.pack_into('>3I', out, U8_HEADER_SIZE + i * U8_NODE_SIZE, val, a, b)
+
+    strings_offset = U8_HEADER_SIZE + len(nodes) * U8_NODE_SIZE
+    out[strings_offset:strings_offset + len(strings)] = strings
+
+    for offset, data in zip(offsets, contents):
+        out[offset:offset + len(data)] = data
+
+    return bytes(out)
+
+def generate_core_pack(filename = 'Race/Common.szs', out_filename = 'Race/Core.arc'):
+    with open(filename, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != struct.pack('>I', U8_SIGNATURE):
+        data = decode_yaz0(data)
+
+    files, bsps = collect_files(U8Archive(data))
+    pack = build_pack(files, bsps)
+
+    # Every file must be found in the pack exactly as it is found in the core archive
+    packed = U8Archive(pack)
+    for name, contents in files.items():
+        assert packed.read(name) == contents, name
+    for name, contents in bsps.items():
+        assert packed.read(f'/{BSP_DIRECTORY}/{name}') == contents, name
+
+    out_dir = os.path.dirname(out_filename)
+    if out_dir:
+        os.makedirs(out_dir, exist_ok=True)
+    with open(out_filename, 'wb') as f:
+        f.write(pack)
+
+    print(f"Packed {len(files) + len(bsps)} files into {out_filename} ({len(pack)} bytes, "
+          f"down from {len(data)} bytes)")
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Generate the core pack, which holds only the files Kinoko "
+                            "reads from Common.szs")
+    parser.add_argument('input', nargs='?', default='Race/Common.szs',
+                        help="Path to Common.szs, compressed or not")
+    parser.add_argument('output', nargs='?', default='Race/Core.arc',
+                        help="Path to the core pack")
+    args = parser.parse_args()
+    generate_core_pack(args.input, args.output)
@@ -0,0 +1,141 @@
+import os
+import struct
+from argparse import ArgumentParser
+
+from generate_core_pack import U8_SIGNATURE, decode_yaz0
+
+# Indexed by course ID, matching COURSE_NAMES in include/Common.hh
+COURSE_NAMES = [
+    'castle_course',
+    'farm_course',
+    'kinoko_course',
+    'volcano_course',
+    'factory_course',
+    'shopping_course',
+    'boardcross_course',
+    'truck_course',
+    'beginner_course',
+    'senior_course',
+    'ridgehighway_course',
+    'treehouse_course',
+    'koopa_course',
+    'rainbow_course',
+    'desert_course',
+    'water_course',
+    'old_peach_gc',
+    'old_mario_gc',
+    'old_waluigi_gc',
+    'old_donkey_gc',
+    'old_falls_ds',
+    'old_desert_ds',
+    'old_garden_ds',
+    'old_town_ds',
+    'old_mario_sfc',
+    'old_obake_sfc',
+    'old_mario_64',
+    'old_sherbet_64',
+    'old_koopa_64',
+    'old_donkey_64',
+    'old_koopa_gba',
+    'old_heyho_gba',
+    'venice_battle',
+    'block_battle',
+    'casino_battle',
+    'skate_battle',
+    'sand_battle',
+    'old_CookieLand_gc',
+    'old_House_ds',
+    'old_battle4_sfc',
+    'old_battle3_gba',
+    'old_matenro_64',
+] + [None] * 12 + [
+    'ring_mission',
+    'winningrun_demo',
+    'loser_demo',
+    'draw_dmeo',
+    'ending_demo',
+]
+
+BUNDLE_MAGIC = b'KCBD'
+BUNDLE_VERSION = 1
+HEADER_SIZE = 0x8
+ENTRY_SIZE = 0x8
+
+# Images are page-aligned, so that each one can be mounted straight from the mapped bundle
+PAGE_SIZE = 0x1000
+
+def align(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+def load_image(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != struct.pack('>I', U8_SIGNATURE):
+        data = decode_yaz0(data)
+
+    if data[:4] != struct.pack('>I', U8_SIGNATURE):
+        raise ValueError(f"{path} is not a course archive")
+
+    return data
+
+def generate_course_bundle(course_dir = 'Race/Course', out_filename = 'Race/Courses.kcb',
+                           courses = None):
+    images = [None] * len(COURSE_NAMES)
+    for i, name in enumerate(COURSE_NAMES):
+        if name is None or (courses and name not in courses):
+            continue
+
+        path = os.path.join(course_dir, name + '.szs')
+        if not os.path.isfile(path):
+            continue
+
+        images[i] = load_image(path)
+
+    if courses:
+        missing = set(courses) - {COURSE_NAMES[i] for i, image in enumerate(images) if image}
+        if missing:
+            raise ValueError(f"Missing course archives: {', '.join(sorted(missing))}")
+
+    # The images follow the index, each starting on its own page
+    entries = []
+    offset = align(HEADER_SIZE + len(COURSE_NAMES) * ENTRY_SIZE, PAGE_SIZE)
+    for image in images:
+        if image is None:
+            entries.append((0, 0))
+            continue
+
+        entries.append((offset // PAGE_SIZE, len(image)))
+        offset = align(offset + len(image), PAGE_SIZE)
+
+    out_dir = os.path.dirname(out_filename)
+    if out_dir:
+        os.makedirs(out_dir, exist_ok=True)
+
+    # Big-endian, like the game's own formats
+    with open(out_filename, 'wb') as f:
+        f.write(struct.pack('>4sHH', BUNDLE_MAGIC, BUNDLE_VERSION, len(COURSE_NAMES)))
+        for page, size in entries:
+            f.write(struct.pack('>II', page, size))
+
+        for (page, _), image in zip(entries, images):
+            if image is None:
+                continue
+
+            f.write(b'\x00' * (page * PAGE_SIZE - f.tell()))
+            f.write(image)
+
+    count = sum(image is not None for image in images)
+    print(f"Bundled {count} courses into {out_filename} ({os.path.getsize(out_filename)} bytes)")
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description="Generate a bundle of decompressed course archives")
+    parser.add_argument('input', nargs='?', default='Race/Course',
+                        help="Directory of course archives, compressed or not")
+    parser.add_argument('output', nargs='?', default='Race/Courses.kcb',
+                        help="Path to the course bundle")
+    parser.add_argument('--course', action='append', dest='courses',
+                        help="Name of a course to bundle, e.g. castle_course. Can be passed "
+                        "multiple times. Defaults to every course in the input directory")
+    args = parser.parse_args()
+    generate_course_bundle(args.input, args.output, args.courses)